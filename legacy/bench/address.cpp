@@ -0,0 +1,268 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+// Compare format::inet/inet6/mac/prefix_len with the libc calls they
+// replace, on a host with many addresses.
+//
+// usage: bench_address [addresses] [iterations]
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/ether.h>
+#include <sys/socket.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <format/address.hpp>
+
+#include "bench.hpp"
+
+using namespace ifshow;
+
+static in6_addr
+make_inet6(std::mt19937_64 &gen)
+{
+    in6_addr a;
+    for(auto &b : a.s6_addr)
+        b = static_cast<uint8_t>(gen());
+
+    // runs of zero groups of random length and position, as in real
+    // addresses
+    //
+    int from = static_cast<int>(gen() % 8), len = static_cast<int>(gen() % 9);
+    for(int g = from; g < from + len && g < 8; g++)
+        a.s6_addr[2 * g] = a.s6_addr[2 * g + 1] = 0;
+    if (gen() % 4 == 0)
+        a.s6_addr[2 * (gen() % 8)] = 0;
+    return a;
+}
+
+
+static bool
+check_inet6(const in6_addr &a)
+{
+    char ref[INET6_ADDRSTRLEN], buf[format::INET6_LEN];
+    inet_ntop(AF_INET6, &a, ref, sizeof(ref));
+    format::inet6(buf, a);
+    if (strcmp(ref, buf)) {
+        std::cerr << "inet6 mismatch: " << ref << " != " << buf << std::endl;
+        return false;
+    }
+    return true;
+}
+
+
+// the replaced code: "%4s" x 8 from /proc/net/if_inet6, sprintf, inet_pton
+// and inet_ntop
+//
+static void
+legacy_inet6_hex(const char *hex, char *out)
+{
+    char p[8][5];
+    for(int i = 0; i < 8; i++) {
+        memcpy(p[i], hex + 4 * i, 4);
+        p[i][4] = '\0';
+    }
+
+    char addr6[40];
+    snprintf(addr6, sizeof(addr6), "%.4s:%.4s:%.4s:%.4s:%.4s:%.4s:%.4s:%.4s", p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7]);
+
+    in6_addr a;
+    inet_pton(PF_INET6, addr6, &a);
+    inet_ntop(PF_INET6, &a, out, 40);
+}
+
+
+static int
+legacy_prefix_len(const in_addr &mask)
+{
+    uint32_t mask_bin = ntohl(mask.s_addr);
+    int prefix_len = 0;
+    while (mask_bin) {
+        prefix_len++;
+        mask_bin <<= 1;
+    }
+    return prefix_len;
+}
+
+
+int
+main(int argc, char *argv[])
+{
+    size_t n    = argc > 1 ? strtoul(argv[1], nullptr, 0) : 100000;
+    size_t iter = argc > 2 ? strtoul(argv[2], nullptr, 0) : 20;
+
+    std::mt19937_64 gen(42);
+
+    // the same strings as libc, edge cases first
+    //
+    for(const char *s : { "::", "::1", "1::", "::2:3", "::1.2.3.4", "::ffff:1.2.3.4", "::fffe:1.2.3.4", "1:0:0:2::3",
+                          "1:0:2:0:0:3:0:0", "1::2:0:0:3", "fe80::1:2", "2001:db8::", "1:2:3:4:5:6:7:8", "0:0:1::", "::ffff:0:0" })
+    {
+        in6_addr a;
+        inet_pton(AF_INET6, s, &a);
+        if (!check_inet6(a))
+            return 1;
+    }
+
+    std::vector<in6_addr> inet6(n);
+    std::vector<in_addr> inet(n), mask(n);
+    std::vector<ether_addr> mac(n);
+    std::vector<std::string> hex(n);
+
+    for(size_t i = 0; i < n; i++)
+    {
+        inet6[i] = make_inet6(gen);
+        inet[i].s_addr = static_cast<uint32_t>(gen());
+        mask[i].s_addr = htonl(i % 33 ? ~uint32_t(0) << (32 - i % 33) : 0);
+        for(auto &b : mac[i].ether_addr_octet)
+            b = static_cast<uint8_t>(gen() % 3 ? gen() : 0);
+
+        char h[33];
+        for(int b = 0; b < 16; b++)
+            snprintf(h + 2 * b, 3, "%02x", inet6[i].s6_addr[b]);
+        hex[i] = h;
+
+        char ref[64], buf[64];
+
+        if (!check_inet6(inet6[i]))
+            return 1;
+
+        inet_ntop(AF_INET, &inet[i], ref, sizeof(ref));
+        format::inet(buf, inet[i]);
+        if (strcmp(ref, buf)) {
+            std::cerr << "inet mismatch: " << ref << " != " << buf << std::endl;
+            return 1;
+        }
+
+        ether_ntoa_r(&mac[i], ref);
+        format::mac(buf, mac[i].ether_addr_octet);
+        if (strcmp(ref, buf)) {
+            std::cerr << "mac mismatch: " << ref << " != " << buf << std::endl;
+            return 1;
+        }
+
+        in6_addr parsed;
+        legacy_inet6_hex(hex[i].c_str(), ref);
+        if (!format::parse_inet6_hex(hex[i], parsed) || (format::inet6(buf, parsed), strcmp(ref, buf))) {
+            std::cerr << "if_inet6 mismatch: " << ref << " != " << buf << std::endl;
+            return 1;
+        }
+
+        if (legacy_prefix_len(mask[i]) != format::prefix_len(mask[i])) {
+            std::cerr << "prefix_len mismatch" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "addresses: " << n << " (ns per pass over all of them)" << std::endl;
+
+    char buf[64];
+
+    double a = bench::run("getnameinfo(NI_NUMERICHOST)", iter, [&] {
+        for(auto &x : inet) {
+            sockaddr_in sin = {};
+            sin.sin_family = AF_INET;
+            sin.sin_addr = x;
+            getnameinfo(reinterpret_cast<sockaddr *>(&sin), sizeof(sin), buf, sizeof(buf), nullptr, 0, NI_NUMERICHOST);
+            bench::keep(buf);
+        }
+    });
+
+    double b = bench::run("inet_ntop(AF_INET)", iter, [&] {
+        for(auto &x : inet) {
+            inet_ntop(AF_INET, &x, buf, sizeof(buf));
+            bench::keep(buf);
+        }
+    });
+
+    double c = bench::run("format::inet", iter, [&] {
+        for(auto &x : inet)
+            bench::keep(format::inet(buf, x));
+    });
+
+    std::cout << "inet: " << a / c << "x getnameinfo, " << b / c << "x inet_ntop" << std::endl;
+
+    double d = bench::run("sprintf + inet_pton + inet_ntop", iter, [&] {
+        for(auto &h : hex) {
+            legacy_inet6_hex(h.c_str(), buf);
+            bench::keep(buf);
+        }
+    });
+
+    double e = bench::run("inet_ntop(AF_INET6)", iter, [&] {
+        for(auto &x : inet6) {
+            inet_ntop(AF_INET6, &x, buf, sizeof(buf));
+            bench::keep(buf);
+        }
+    });
+
+    double f = bench::run("parse_inet6_hex + format::inet6", iter, [&] {
+        in6_addr x;
+        for(auto &h : hex) {
+            format::parse_inet6_hex(h, x);
+            bench::keep(format::inet6(buf, x));
+        }
+    });
+
+    double g = bench::run("format::inet6", iter, [&] {
+        for(auto &x : inet6)
+            bench::keep(format::inet6(buf, x));
+    });
+
+    std::cout << "inet6: " << d / f << "x if_inet6 path, " << e / g << "x inet_ntop" << std::endl;
+
+    double h = bench::run("ether_ntoa_r", iter, [&] {
+        for(auto &x : mac) {
+            ether_ntoa_r(&x, buf);
+            bench::keep(buf);
+        }
+    });
+
+    double i = bench::run("format::mac", iter, [&] {
+        for(auto &x : mac)
+            bench::keep(format::mac(buf, x.ether_addr_octet));
+    });
+
+    std::cout << "mac: " << h / i << "x ether_ntoa_r" << std::endl;
+
+    double j = bench::run("shift loop prefix length", iter, [&] {
+        int s = 0;
+        for(auto &x : mask)
+            s += legacy_prefix_len(x);
+        bench::keep(s);
+    });
+
+    double k = bench::run("format::prefix_len", iter, [&] {
+        int s = 0;
+        for(auto &x : mask)
+            s += format::prefix_len(x);
+        bench::keep(s);
+    });
+
+    std::cout << "prefix_len: " << j / k << "x shift loop" << std::endl;
+    return 0;
+}
+
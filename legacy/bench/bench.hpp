@@ -0,0 +1,62 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+namespace bench {
+
+    // prevent the compiler from optimizing away a value
+    //
+    template <typename T>
+    inline void
+    keep(T const &value)
+    {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+    // run fun() n times (after a short warm-up) and print the time per call
+    //
+    template <typename Fun>
+    double
+    run(const std::string &name, size_t n, Fun fun)
+    {
+        for(size_t i = 0; i < n / 10 + 1; i++)
+            fun();
+
+        auto begin = std::chrono::steady_clock::now();
+
+        for(size_t i = 0; i < n; i++)
+            fun();
+
+        auto end = std::chrono::steady_clock::now();
+
+        double ns = std::chrono::duration<double, std::nano>(end - begin).count() / n;
+
+        std::cout << std::left << std::setw(40) << name << std::right << std::setw(14)
+                  << std::fixed << std::setprecision(1) << ns << " ns/op" << std::endl;
+        return ns;
+    }
+
+} // namespace bench
+
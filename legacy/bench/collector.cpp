@@ -0,0 +1,134 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+// Compare a full libifshow sample (every probe, as ifshow --snapshot does)
+// with the incremental re-sampling of the counters, and check that the
+// C ABI and the re-sampled properties agree with a fresh collector.
+//
+// usage: bench_collector [iterations] [ifname...]
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <libifshow.h>
+#include <libifshow.hpp>
+#include <snapshot/snapshot.hpp>
+
+#include "bench.hpp"
+
+static bool
+same_properties(const libifshow::snapshot &a, const libifshow::snapshot &b)
+{
+    if (a.interfaces.size() != b.interfaces.size())
+        return false;
+
+    for(size_t i = 0; i < a.interfaces.size(); i++)
+    {
+        auto &x = a.interfaces[i], &y = b.interfaces[i];
+        if (x.name != y.name)
+            return false;
+
+        std::vector<const libifshow::field *> px, py;
+        for(auto &f : x.fields)
+            if (!ifshow::snapshot::is_counter(f.key))
+                px.push_back(&f);
+        for(auto &f : y.fields)
+            if (!ifshow::snapshot::is_counter(f.key))
+                py.push_back(&f);
+
+        if (px.size() != py.size())
+            return false;
+        for(size_t j = 0; j < px.size(); j++)
+            if (px[j]->key != py[j]->key || px[j]->value != py[j]->value)
+                return false;
+    }
+    return true;
+}
+
+
+int
+main(int argc, char *argv[])
+{
+    size_t iter = argc > 1 ? strtoul(argv[1], nullptr, 0) : 200;
+    std::vector<std::string> ifnames(argv + std::min(argc, 2), argv + argc);
+
+    libifshow::collector c(ifnames);
+
+    auto first = c.sample();
+    auto &next = c.sample();
+
+    if (next.generation != 2 || !same_properties(first, next)) {
+        std::cerr << "re-sample mismatch!" << std::endl;
+        return 1;
+    }
+
+    // the C ABI sees the same snapshot
+    //
+    std::vector<const char *> names;
+    for(auto &n : ifnames)
+        names.push_back(n.c_str());
+
+    auto cc = ifshow_collector_new(names.data(), names.size());
+    auto s  = cc ? ifshow_sample(cc) : nullptr;
+
+    if (!s || ifshow_snapshot_interfaces(s) != first.interfaces.size()) {
+        std::cerr << "C ABI mismatch: " << (cc ? ifshow_error(cc) : "no collector") << std::endl;
+        return 1;
+    }
+
+    for(size_t i = 0; i < first.interfaces.size(); i++)
+    {
+        auto &x = first.interfaces[i];
+        if (x.name != ifshow_interface_name(s, i) || ifshow_snapshot_find(s, x.name.c_str()) != long(i) ||
+            ifshow_interface_fields(s, i) != x.fields.size()) {
+            std::cerr << "C ABI mismatch on " << x.name << std::endl;
+            return 1;
+        }
+
+        auto mtu = ifshow_interface_get(s, i, "mtu");
+        if ((mtu ? std::string(mtu) : std::string()) != x.get("mtu")) {
+            std::cerr << "C ABI mismatch on " << x.name << " mtu" << std::endl;
+            return 1;
+        }
+    }
+
+    ifshow_collector_free(cc);
+
+    size_t fields = 0;
+    for(auto &i : first.interfaces)
+        fields += i.fields.size();
+
+    std::cout << "interfaces: " << first.interfaces.size() << ", fields: " << fields << std::endl;
+
+    double a = bench::run("full sample", iter, [&] {
+        c.invalidate();
+        bench::keep(c.sample().generation);
+    });
+
+    double b = bench::run("incremental sample", iter, [&] {
+        bench::keep(c.sample().generation);
+    });
+
+    std::cout << "speedup: " << a / b << "x" << std::endl;
+    return 0;
+}
+
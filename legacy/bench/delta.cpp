@@ -0,0 +1,105 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+// Compare counter_delta() with a value-by-value loop on the driver
+// statistics of several 64-queue NICs (a few thousands u64 counters).
+//
+// usage: bench_delta [counters] [iterations]
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <watch/delta.hpp>
+
+#include "bench.hpp"
+
+using namespace ifshow;
+
+static size_t
+naive_delta(const uint64_t *prev, const uint64_t *cur, uint64_t *delta, std::vector<size_t> &changed, size_t n)
+{
+    changed.clear();
+
+    for(size_t i = 0; i < n; i++)
+    {
+        uint64_t d;
+        if (cur[i] >= prev[i])
+            d = cur[i] - prev[i];
+        else if (prev[i] <= UINT32_MAX && (uint64_t(1) << 32) - prev[i] + cur[i] < (uint64_t(1) << 31))
+            d = (uint64_t(1) << 32) - prev[i] + cur[i];
+        else
+            d = cur[i];
+
+        delta[i] = d;
+        if (d)
+            changed.push_back(i);
+    }
+
+    return changed.size();
+}
+
+
+int
+main(int argc, char *argv[])
+{
+    size_t n     = argc > 1 ? strtoul(argv[1], nullptr, 0) : 8192;
+    size_t iter  = argc > 2 ? strtoul(argv[2], nullptr, 0) : 100000;
+
+    std::mt19937_64 gen(42);
+    std::vector<uint64_t> prev(n), cur(n), delta(n), mask(watch::mask_words(n)), ref(n);
+
+    // most of the counters don't move between two samples...
+    //
+    for(size_t i = 0; i < n; i++)
+    {
+        prev[i] = gen() >> (i % 2 ? 32 : 8);
+        cur[i]  = prev[i] + (gen() % 8 == 0 ? gen() % 100000 : 0);
+    }
+
+    // ...a few 32-bit counters wrap and one is reset
+    //
+    prev[1] = UINT32_MAX - 10; cur[1] = 5;
+    prev[3] = 123456; cur[3] = 0;
+
+    std::vector<size_t> changed;
+    size_t nr = naive_delta(prev.data(), cur.data(), ref.data(), changed, n);
+    auto res = watch::counter_delta(prev.data(), cur.data(), delta.data(), mask.data(), n);
+
+    if (ref != delta || nr != res.changed) {
+        std::cerr << "counter_delta mismatch!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "counters: " << n << ", changed: " << res.changed << ", wrapped: " << res.wrapped
+              << ", reset: " << res.reset << std::endl;
+
+    double a = bench::run("naive delta + changed list", iter, [&] {
+        bench::keep(naive_delta(prev.data(), cur.data(), delta.data(), changed, n));
+    });
+
+    double b = bench::run("counter_delta", iter, [&] {
+        bench::keep(watch::counter_delta(prev.data(), cur.data(), delta.data(), mask.data(), n));
+    });
+
+    std::cout << "speedup: " << a / b << "x" << std::endl;
+    return 0;
+}
+
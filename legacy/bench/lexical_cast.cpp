@@ -0,0 +1,117 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+// Compare the stringstream lexical_cast policy with the std::from_chars
+// one on the labels of /proc/interrupts ("41", "NMI", "LOC"...).
+//
+// usage: bench_lexical_cast [iterations]
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <lexical_cast.hpp>
+
+#include "bench.hpp"
+
+using namespace more;
+
+template <typename T>
+static std::optional<T>
+stream_cast(const std::string &s)
+{
+    return detail::generic_lexical_cast_policy<T, std::string>::try_apply(s);
+}
+
+
+template <typename T>
+static bool
+check(const std::vector<std::string> &in)
+{
+    for(auto &s : in)
+    {
+        // operator>> wraps "-5" into an unsigned, from_chars rejects it
+        //
+        if (std::is_unsigned<T>::value && s.find('-') != std::string::npos)
+            continue;
+
+        if (stream_cast<T>(s) != try_lexical_cast<T>(s)) {
+            std::cerr << "lexical_cast mismatch on '" << s << "'" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+
+int
+main(int argc, char *argv[])
+{
+    size_t iter = argc > 1 ? strtoul(argv[1], nullptr, 0) : 1000000;
+
+    std::vector<std::string> edge = { "0", "42", " 42", "42 ", "  7\t", "+5", "-5", "+-5", "+", "-", "", " ",
+                                      "4 2", "42x", "x42", "2147483647", "2147483648", "-2147483648", "-2147483649",
+                                      "NMI", "LOC", "0x10", "007" };
+
+    if (!check<int>(edge) || !check<long long>(edge) || !check<unsigned short>(edge) ||
+        !check<double>({ "1", "1.5", " -2.25 ", "1e3", "1e", ".5", "5.", "x" }))
+        return 1;
+
+    // a 64-CPU box: ~200 device interrupts and the per-CPU ones
+    //
+    std::vector<std::string> labels;
+    for(int i = 0; i < 200; i++)
+        labels.push_back(std::to_string(i));
+    for(auto l : { "NMI", "LOC", "SPU", "PMI", "IWI", "RTR", "RES", "CAL", "TLB", "TRM", "THR", "DFR", "MCE", "MCP", "ERR", "MIS", "PIN", "NPI", "PIW" })
+        labels.push_back(l);
+
+    size_t i = 0;
+
+    // the numeric labels: the cost of the conversion alone
+    //
+    double a = bench::run("stringstream lexical_cast<int>", iter, [&] {
+        bench::keep(detail::generic_lexical_cast_policy<int, std::string>::apply(labels[i++ % 200]));
+    });
+
+    double b = bench::run("from_chars lexical_cast<int>", iter, [&] {
+        bench::keep(lexical_cast<int>(labels[i++ % 200]));
+    });
+
+    std::cout << "speedup: " << a / b << "x" << std::endl;
+
+    // all the labels: the non-numeric ones throw, unless try_lexical_cast
+    //
+    double c = bench::run("stringstream lexical_cast<int>, all", iter, [&] {
+        try {
+            bench::keep(detail::generic_lexical_cast_policy<int, std::string>::apply(labels[i++ % labels.size()]));
+        }
+        catch(bad_lexical_cast &) {
+        }
+    });
+
+    double d = bench::run("try_lexical_cast<int>, all", iter, [&] {
+        bench::keep(try_lexical_cast<int>(labels[i++ % labels.size()]));
+    });
+
+    std::cout << "speedup: " << c / d << "x" << std::endl;
+    return 0;
+}
+
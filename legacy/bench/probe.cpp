@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+// Compare the cost of a failing probe (ETHTOOL_GSET, ETHTOOL_GDRVINFO and
+// the wireless extensions on virtual interfaces) when the failure is
+// reported with an exception vs a result<T>.
+//
+// usage: bench_probe [iterations] [if...]
+
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+
+#include <ifr.hpp>
+
+#include "bench.hpp"
+
+using namespace ifshow;
+
+int
+main(int argc, char *argv[])
+{
+    size_t iter = argc > 1 ? strtoul(argv[1], nullptr, 0) : 100000;
+
+    std::vector<std::string> ifs;
+    for(int i = 2; i < argc; i++)
+        ifs.push_back(argv[i]);
+    if (ifs.empty())
+        ifs.push_back("lo");
+
+    std::vector<ifr> iifs;
+    for(auto &name : ifs)
+        iifs.emplace_back(name);
+
+    // both paths must see the same outcome...
+    //
+    size_t failures = 0;
+    for(auto &iif : iifs)
+    {
+        bool threw = false;
+        try { iif.ethtool_command(); } catch(std::system_error &) { threw = true; }
+
+        auto r = iif.try_ethtool_command();
+        if (threw == static_cast<bool>(r)) {
+            std::cerr << iif.name() << ": try_ethtool_command mismatch!" << std::endl;
+            return 1;
+        }
+
+        failures += threw;
+    }
+
+    std::cout << "interfaces: " << iifs.size() << ", failing ethtool_command: " << failures << std::endl;
+
+    double a = bench::run("probes (throw/catch)", iter, [&] {
+        for(auto &iif : iifs)
+        {
+            try { bench::keep(iif.ethtool_command()); } catch(std::exception &) { }
+            try { bench::keep(iif.ethtool_info()); } catch(std::exception &) { }
+            try { bench::keep(iif.wifi_info()); } catch(std::exception &) { }
+        }
+    });
+
+    double b = bench::run("probes (result)", iter, [&] {
+        for(auto &iif : iifs)
+        {
+            bench::keep(iif.try_ethtool_command());
+            bench::keep(iif.try_ethtool_info());
+            bench::keep(iif.try_wifi_info());
+        }
+    });
+
+    std::cout << "speedup: " << a / b << "x" << std::endl;
+    return 0;
+}
+
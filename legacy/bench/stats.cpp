@@ -0,0 +1,77 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+// Compare the cost of sampling the counters of a few interfaces via
+// /proc/net/dev (ifr::get_stats), a netlink RTM_GETLINK dump and the
+// persistent-fd sysfs sampler.
+//
+// usage: bench_stats [iterations] [if...]
+
+#include <cstdlib>
+#include <iostream>
+
+#include <ifr.hpp>
+#include <proc/net_dev.hpp>
+#include <netlink/link.hpp>
+#include <sysfs/stats.hpp>
+
+#include "bench.hpp"
+
+using namespace ifshow;
+
+int
+main(int argc, char *argv[])
+{
+    size_t n = argc > 1 ? strtoul(argv[1], nullptr, 0) : 10000;
+
+    std::vector<ifname> ifs(argv + std::min(argc, 2), argv + argc);
+
+    if (ifs.empty())
+        ifs = proc::get_if_list();
+
+    std::cout << "interfaces sampled: " << ifs.size() << ", in the system: "
+              << proc::get_if_list().size() << std::endl;
+
+    bench::run("proc: ifr::get_stats()", n, [&] {
+        for(auto &name : ifs)
+            bench::keep(ifr(name).get_stats());
+    });
+
+    bench::run("netlink: RTM_GETLINK dump", n, [&] {
+        bench::keep(netlink::get_links());
+    });
+
+    sysfs::stats_sampler all(ifs);
+    std::vector<uint64_t> out(all.size());
+
+    bench::run("sysfs: stats_sampler (12 counters)", n, [&] {
+        all.sample(out.data());
+        bench::keep(out);
+    });
+
+    sysfs::stats_sampler bytes(ifs, { sysfs::stats_sampler::rx_bytes, sysfs::stats_sampler::tx_bytes });
+
+    bench::run("sysfs: stats_sampler (rx/tx bytes)", n, [&] {
+        bytes.sample(out.data());
+        bench::keep(out);
+    });
+
+    return 0;
+}
+
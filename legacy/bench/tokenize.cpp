@@ -0,0 +1,240 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+// Compare more::getline() (one streambuf call per char) with
+// more::tokenizer on a synthetic /proc/net/dev of many interfaces, and
+// more::split/trim_copy with the string_view tokens/trim_view. The
+// string_view versions are first checked against the legacy ones.
+//
+// usage: bench_tokenize [lines] [iterations]
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <iomanip.hpp>
+#include <string-utils.hpp>
+
+#include <proc/net_dev.hpp>
+
+#include "bench.hpp"
+
+using namespace ifshow;
+
+static std::string
+make_net_dev(size_t lines)
+{
+    std::mt19937_64 gen(42);
+    std::string ret =
+        "Inter-|   Receive                                                |  Transmit\n"
+        " face |bytes    packets errs drop fifo frame compressed multicast|bytes    packets errs drop fifo colls carrier compressed\n";
+
+    char line[256];
+    for(size_t i = 0; i < lines; i++)
+    {
+        std::string name = "eth" + std::to_string(i);
+        unsigned long long v[16];
+        for(auto &x : v)
+            x = gen() % 4 == 0 ? 0 : gen() >> (gen() % 48 + 16);
+
+        snprintf(line, sizeof(line), "%6s: %7llu %7llu %4llu %4llu %4llu %5llu %10llu %9llu %8llu %7llu %4llu %4llu %4llu %5llu %7llu %10llu\n",
+                 name.c_str(), v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8], v[9], v[10], v[11], v[12], v[13], v[14], v[15]);
+        ret += line;
+    }
+
+    return ret;
+}
+
+
+static std::vector<std::string>
+legacy_tokens(const std::string &text, const std::string &delim)
+{
+    std::vector<std::string> ret;
+    std::istringstream in(text);
+    more::string_token tok(delim);
+    while (in >> tok)
+        ret.push_back(tok);
+    return ret;
+}
+
+
+static std::vector<std::string>
+tokenizer_tokens(const std::string &text, const std::string &delim)
+{
+    std::vector<std::string> ret;
+    more::tokenizer tok(text, delim);
+    std::string_view t;
+    while (tok.next(t))
+        ret.emplace_back(t);
+    return ret;
+}
+
+
+int
+main(int argc, char *argv[])
+{
+    size_t lines = argc > 1 ? strtoul(argv[1], nullptr, 0) : 100000;
+    size_t iter  = argc > 2 ? strtoul(argv[2], nullptr, 0) : 20;
+
+    auto text = make_net_dev(lines);
+
+    // the same tokens, including the corner cases of getline: leading
+    // delimiters, runs of delimiters and no trailing delimiter
+    //
+    for(std::string t : { text, std::string("  a::b  c"), std::string(":::"), std::string("x"), std::string() })
+    {
+        for(std::string d : { std::string(" :\n"), std::string("\n"), std::string(":"), std::string(" \f\n\r\t\v:|") })
+        {
+            if (legacy_tokens(t, d) != tokenizer_tokens(t, d)) {
+                std::cerr << "tokenizer mismatch!" << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    // escapes: the tokenizer keeps the backslashes, unescape() drops them
+    //
+    for(std::string t : { std::string("a\\ b c"), std::string("a\\\\ b"), std::string("\\x:y\\"), std::string("\\"),
+                          std::string("  a\\:b::c\\"), std::string("\\\\"), std::string("a\\\n b") })
+    {
+        for(std::string d : { std::string(" "), std::string(" :"), std::string("\n") })
+        {
+            std::vector<std::string> legacy, views;
+
+            std::istringstream in(t);
+            std::string tok;
+            while (more::getline(in, tok, d, more::string_utils::escape_enabled))
+                legacy.push_back(tok);
+
+            for(auto v : more::tokens(t, d, more::string_utils::escape_enabled))
+                views.push_back(more::unescape(v, d));
+
+            if (legacy != views) {
+                std::cerr << "escaped tokenizer mismatch!" << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    // split_view and the trim views
+    //
+    for(std::string t : { std::string("  eth0: 1 2  3 "), std::string("a--b-c"), std::string("--"), std::string(" \t x \n"),
+                          std::string("   "), std::string("x"), std::string() })
+    {
+        for(std::string d : { std::string(" "), std::string("--"), std::string("-"), std::string(": ") })
+        {
+            std::vector<std::string> legacy;
+            std::vector<std::string_view> views;
+            more::split(t, std::back_inserter(legacy), d);
+            more::split_view(t, std::back_inserter(views), d);
+
+            if (!std::equal(legacy.begin(), legacy.end(), views.begin(), views.end())) {
+                std::cerr << "split_view mismatch!" << std::endl;
+                return 1;
+            }
+        }
+
+        if (more::trim_copy(t) != more::trim_view(t) ||
+            more::left_trim_copy(t) != more::left_trim_view(t) ||
+            more::right_trim_copy(t) != more::right_trim_view(t) ||
+            more::trim_copy(t, " e") != more::trim_view(t, " e")) {
+            std::cerr << "trim_view mismatch!" << std::endl;
+            return 1;
+        }
+    }
+
+    if (proc::parse_if_list(text).size() != lines) {
+        std::cerr << "parse_if_list mismatch!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "lines: " << lines << ", bytes: " << text.size() << std::endl;
+
+    double a = bench::run("more::getline fields", iter, [&] {
+        std::istringstream in(text);
+        more::string_token tok(" :\n");
+        size_t n = 0;
+        while (in >> tok)
+            n += tok.str().size();
+        bench::keep(n);
+    });
+
+    double b = bench::run("more::tokenizer fields", iter, [&] {
+        more::tokenizer tok(text, " :\n");
+        std::string_view t;
+        size_t n = 0;
+        while (tok.next(t))
+            n += t.size();
+        bench::keep(n);
+    });
+
+    std::cout << "speedup: " << a / b << "x" << std::endl;
+
+    double c = bench::run("more::getline lines", iter, [&] {
+        std::istringstream in(text);
+        more::string_token tok("\n");
+        size_t n = 0;
+        while (in >> tok)
+            n += tok.str().size();
+        bench::keep(n);
+    });
+
+    double d = bench::run("more::tokenizer lines", iter, [&] {
+        more::tokenizer tok(text, "\n");
+        std::string_view t;
+        size_t n = 0;
+        while (tok.next(t))
+            n += t.size();
+        bench::keep(n);
+    });
+
+    std::cout << "speedup: " << c / d << "x" << std::endl;
+
+    // a line at a time, as the proc parsers do
+    //
+    std::string line = "  eth0: 1234567 8901 0 0 0 0 0 12 7654321 4321 0 0 0 0 0 0";
+
+    double e = bench::run("more::split + trim_copy (line)", iter * 10000, [&] {
+        std::vector<std::string> v;
+        more::split(more::trim_copy(line), std::back_inserter(v), std::string(" :"));
+        bench::keep(v);
+    });
+
+    double f = bench::run("more::tokens + trim_view (line)", iter * 10000, [&] {
+        size_t n = 0;
+        for(auto t : more::tokens(more::trim_view(line), " :"))
+            n += t.size();
+        bench::keep(n);
+    });
+
+    std::cout << "speedup: " << e / f << "x" << std::endl;
+
+    bench::run("proc::parse_if_list", iter, [&] {
+        bench::keep(proc::parse_if_list(text));
+    });
+
+    return 0;
+}
+
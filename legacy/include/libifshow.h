@@ -0,0 +1,86 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef LIBIFSHOW_H
+#define LIBIFSHOW_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * The C interface of libifshow (see libifshow.hpp). The snapshot returned
+ * by ifshow_sample() belongs to the collector and is valid until the next
+ * sample, or until the collector is freed. No function throws: the ones
+ * that fail return NULL (or -1) and ifshow_error() tells why.
+ *
+ * NULL handles and arguments are accepted everywhere: the getters return
+ * NULL, 0 or -1, ifshow_invalidate() and ifshow_collector_free() do nothing.
+ *
+ * Different collectors can be sampled from different threads at the same
+ * time; a collector and its snapshot must be used by one thread at a time.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ifshow_collector ifshow_collector;
+typedef struct ifshow_snapshot  ifshow_snapshot;
+
+/* the interfaces to sample (all of them if n is 0) */
+
+extern ifshow_collector *ifshow_collector_new(const char * const *ifnames, size_t n);
+
+extern void ifshow_collector_free(ifshow_collector *c);
+
+/* the last error of the collector, "" if none */
+
+extern const char *ifshow_error(const ifshow_collector *c);
+
+extern const ifshow_snapshot *ifshow_sample(ifshow_collector *c);
+
+extern void ifshow_invalidate(ifshow_collector *c);
+
+extern double   ifshow_snapshot_time(const ifshow_snapshot *s);
+extern uint64_t ifshow_snapshot_generation(const ifshow_snapshot *s);
+extern size_t   ifshow_snapshot_interfaces(const ifshow_snapshot *s);
+
+/* the index of the interface, -1 if not present */
+
+extern long ifshow_snapshot_find(const ifshow_snapshot *s, const char *ifname);
+
+extern const char *ifshow_interface_name(const ifshow_snapshot *s, size_t i);
+extern size_t      ifshow_interface_fields(const ifshow_snapshot *s, size_t i);
+extern const char *ifshow_interface_key(const ifshow_snapshot *s, size_t i, size_t f);
+extern const char *ifshow_interface_value(const ifshow_snapshot *s, size_t i, size_t f);
+
+/* the value of key, NULL if not present */
+
+extern const char *ifshow_interface_get(const ifshow_snapshot *s, size_t i, const char *key);
+
+/* the value of a counter key into *value: 0, or -1 if not present */
+
+extern int ifshow_interface_counter(const ifshow_snapshot *s, size_t i, const char *key, uint64_t *value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBIFSHOW_H */
+
@@ -0,0 +1,114 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * libifshow: the collectors of ifshow as a library, for the agents that
+ * would otherwise run ifshow and parse its output.
+ *
+ * A snapshot holds, for every interface, the properties and the counters
+ * that `ifshow --snapshot` writes to a file, with the same keys (the file
+ * format is the stable interface): stat.* (rtnl_link_stats64), ethtool.*
+ * (the non-zero driver statistics), flags, mtu, mac, driver, bus, ring.*,
+ * channel.*, coalesce.*, features, irq.N...
+ *
+ * The first sample of a collector probes everything; the next ones only
+ * re-read the counters (a netlink dump and ETHTOOL_GSTATS), unless the
+ * set of interfaces changed or invalidate() is called.
+ *
+ * Threads: different collectors can be sampled concurrently (the netlink
+ * sockets are per thread). A collector and its snapshot must not be used
+ * by two threads at the same time.
+ */
+
+namespace libifshow {
+
+    struct field
+    {
+        std::string key;
+        std::string value;
+    };
+
+    struct interface
+    {
+        std::string         name;
+        std::vector<field>  fields;     // sorted by key
+
+        // the field of key, nullptr if not present
+        //
+        const field * find(std::string_view key) const;
+
+        // the value of key, empty if not present
+        //
+        std::string_view get(std::string_view key) const;
+
+        // the value of a counter key, 0 if not present
+        //
+        uint64_t counter(std::string_view key) const;
+    };
+
+    struct snapshot
+    {
+        std::string             host;
+        double                  time;           // seconds since the epoch
+        uint64_t                generation;     // the number of samples taken
+        std::vector<interface>  interfaces;     // sorted by name
+
+        // the interface by name, nullptr if not present
+        //
+        const interface * find(std::string_view name) const;
+    };
+
+    class collector
+    {
+    public:
+        // the interfaces to sample, all of them if empty
+        //
+        explicit collector(std::vector<std::string> ifnames = {});
+        ~collector();
+
+        collector(collector &&) noexcept;
+        collector& operator=(collector &&) noexcept;
+
+        collector(const collector &) = delete;
+        collector& operator=(const collector &) = delete;
+
+        // take a sample: the reference is valid until the next call;
+        // throws std::exception on failure
+        //
+        const snapshot & sample();
+
+        // probe everything again at the next sample
+        //
+        void invalidate();
+
+    private:
+        struct impl;
+        std::unique_ptr<impl> m_impl;
+    };
+
+} // namespace libifshow
+
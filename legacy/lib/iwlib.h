@@ -508,8 +508,10 @@ iw_set_ext(int			skfd,		/* Socket to the kernel */
 	   int			request,	/* WE ID */
 	   struct iwreq *	pwrq)		/* Fixed part of the request */
 {
-  /* Set device name */
-  strncpy(pwrq->ifr_name, ifname, IFNAMSIZ);
+  /* Set device name (bounded and always terminated) */
+  size_t len = strnlen(ifname, IFNAMSIZ - 1);
+  memcpy(pwrq->ifr_name, ifname, len);
+  pwrq->ifr_name[len] = '\0';
   /* Do the request */
   return(ioctl(skfd, request, pwrq));
 }
@@ -524,8 +526,10 @@ iw_get_ext(int			skfd,		/* Socket to the kernel */
 	   int			request,	/* WE ID */
 	   struct iwreq *	pwrq)		/* Fixed part of the request */
 {
-  /* Set device name */
-  strncpy(pwrq->ifr_name, ifname, IFNAMSIZ);
+  /* Set device name (bounded and always terminated) */
+  size_t len = strnlen(ifname, IFNAMSIZ - 1);
+  memcpy(pwrq->ifr_name, ifname, len);
+  pwrq->ifr_name[len] = '\0';
   /* Do the request */
   return(ioctl(skfd, request, pwrq));
 }
@@ -15,7 +15,11 @@
 #include <typeinfo>
 #include <sstream>
 #include <cassert>
+#include <cctype>
+#include <charconv>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <type_traits>
 
 /////////////////////////////////////////////////////////////
@@ -63,6 +67,58 @@ namespace more {
                 }
                 return ret;
             }
+
+            static
+            std::optional<Target>
+            try_apply(const Source &arg)
+            {
+                try {
+                    return apply(arg);
+                }
+                catch(bad_lexical_cast &) {
+                    return std::nullopt;
+                }
+            }
+        };
+
+        // numbers from strings: std::from_chars, with the same leading and
+        // trailing blanks and the '+' sign accepted by operator>>
+        //
+
+        template <typename Target, typename Source>
+        struct from_chars_lexical_cast_policy
+        {
+            static
+            std::optional<Target>
+            try_apply(const Source &arg)
+            {
+                std::string_view str(arg);
+
+                const char *b = str.data(), *e = b + str.size();
+
+                while (b != e && std::isspace(static_cast<unsigned char>(*b)))
+                    ++b;
+                while (e != b && std::isspace(static_cast<unsigned char>(e[-1])))
+                    --e;
+                if (e - b > 1 && *b == '+' && b[1] != '-')
+                    ++b;
+
+                Target ret;
+                auto r = std::from_chars(b, e, ret);
+                if (r.ec != std::errc() || r.ptr != e)
+                    return std::nullopt;
+                return ret;
+            }
+
+            static
+            Target
+            apply(const Source &arg)
+            {
+                auto ret = try_apply(arg);
+                if (!ret)
+                    throw bad_lexical_cast();
+                return *ret;
+            }
         };
 
         template <typename Target, typename Source>
@@ -73,6 +129,12 @@ namespace more {
             {
                 return arg;
             };
+
+            static
+            std::optional<Target> try_apply(const Source &arg)
+            {
+                return arg;
+            }
         };
         
         template <typename T>
@@ -83,19 +145,55 @@ namespace more {
             {
                 return arg;
             }
+
+            static
+            std::optional<T> try_apply(const T &arg)
+            {
+                return arg;
+            }
         };
-        
+
+        /////////////////////////////////////////// from_chars targets and sources
+
+        template <typename T>
+        struct is_from_chars_target : std::integral_constant<bool, std::is_arithmetic<T>::value &&
+                                                                   !std::is_same<T, bool>::value &&
+                                                                   !std::is_same<T, char>::value &&
+                                                                   !std::is_same<T, signed char>::value &&
+                                                                   !std::is_same<T, unsigned char>::value &&
+                                                                   !std::is_same<T, wchar_t>::value>
+        {};
+
+        template <typename T>
+        struct is_from_chars_source : std::integral_constant<bool, std::is_same<T, std::string>::value ||
+                                                                   std::is_same<T, std::string_view>::value ||
+                                                                   std::is_same<typename std::decay<T>::type, char *>::value ||
+                                                                   std::is_same<typename std::decay<T>::type, const char *>::value>
+        {};
+
+        template <typename Target, typename Source>
+        struct use_from_chars : std::integral_constant<bool, is_from_chars_target<Target>::value &&
+                                                             is_from_chars_source<Source>::value>
+        {};
+
         /////////////////////////////////////////// lexical_traits
 
         template <typename Target, typename Source, typename Enable = void> 
         struct lexical_traits;
 
         template <typename Target, typename Source> 
-        struct lexical_traits<Target, Source, typename std::enable_if<!std::is_convertible<Source,Target>::value>::type> 
+        struct lexical_traits<Target, Source, typename std::enable_if<!std::is_convertible<Source,Target>::value &&
+                                                                     !use_from_chars<Target,Source>::value>::type> 
         {
             typedef generic_lexical_cast_policy<Target,Source> policy; 
         };
 
+        template <typename Target, typename Source> 
+        struct lexical_traits<Target, Source, typename std::enable_if<use_from_chars<Target,Source>::value>::type> 
+        {
+            typedef from_chars_lexical_cast_policy<Target,Source> policy; 
+        };
+
         template <typename Target, typename Source> 
         struct lexical_traits<Target, Source, typename std::enable_if<std::is_convertible<Source,Target>::value && 
                                                                      !std::is_same<Source,Target>::value>::type> 
@@ -117,6 +215,15 @@ namespace more {
         return detail::lexical_traits<typename std::remove_reference<Target>::type,Source>::policy::apply(arg);
     }  
 
+    // as lexical_cast, but an empty optional instead of bad_lexical_cast
+    //
+    template <typename Target, typename Source> 
+    std::optional<typename std::remove_reference<Target>::type>
+    try_lexical_cast(const Source &arg)
+    {
+        return detail::lexical_traits<typename std::remove_reference<Target>::type,Source>::policy::try_apply(arg);
+    }  
+
 } // namespace more
 
 #endif /* _LEXICAL_CAST_HH_ */
@@ -14,9 +14,16 @@
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <algorithm>
 #include <iterator>
 #include <limits>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 namespace more { 
 
@@ -110,6 +117,292 @@ namespace more {
         return __in;
     }
 
+    // a set of delimiter bytes: a single delimiter is searched with memchr,
+    // up to 8 with SSE2/AVX2 byte compares and larger sets with a bitmap...
+    //
+
+    class char_set
+    {
+    public:
+        char_set(std::string_view chars)
+        : m_bitmap()
+        , m_chars()
+        , m_size(chars.size())
+        {
+            for(unsigned char c : chars)
+                m_bitmap[c >> 6] |= uint64_t(1) << (c & 63);
+            std::memcpy(m_chars, chars.data(), std::min(chars.size(), sizeof(m_chars)));
+        }
+
+        void
+        insert(char c)
+        {
+            unsigned char u = static_cast<unsigned char>(c);
+            m_bitmap[u >> 6] |= uint64_t(1) << (u & 63);
+            if (m_size < sizeof(m_chars))
+                m_chars[m_size] = c;
+            m_size++;
+        }
+
+        bool
+        contains(char c) const
+        {
+            unsigned char u = static_cast<unsigned char>(c);
+            return (m_bitmap[u >> 6] >> (u & 63)) & 1;
+        }
+
+        // the first char of [b, e) in the set, e if none
+        //
+        const char *
+        find(const char *b, const char *e) const
+        {
+            if (m_size == 1) {
+                auto p = static_cast<const char *>(std::memchr(b, m_chars[0], static_cast<size_t>(e - b)));
+                return p ? p : e;
+            }
+            return scan<true>(b, e);
+        }
+
+        // the first char of [b, e) not in the set, e if none
+        //
+        const char *
+        find_not(const char *b, const char *e) const
+        {
+            return scan<false>(b, e);
+        }
+
+    private:
+        template <bool In>
+        const char *
+        scan(const char *b, const char *e) const
+        {
+            if (m_size <= sizeof(m_chars))
+            {
+#if defined(__AVX2__)
+                for(; e - b >= 32; b += 32)
+                {
+                    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b));
+                    __m256i m = _mm256_setzero_si256();
+                    for(size_t i = 0; i < m_size; i++)
+                        m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(m_chars[i])));
+
+                    uint32_t bits = static_cast<uint32_t>(_mm256_movemask_epi8(m));
+                    if (!In)
+                        bits = ~bits;
+                    if (bits)
+                        return b + __builtin_ctz(bits);
+                }
+#endif
+#if defined(__SSE2__)
+                for(; e - b >= 16; b += 16)
+                {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b));
+                    __m128i m = _mm_setzero_si128();
+                    for(size_t i = 0; i < m_size; i++)
+                        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8(m_chars[i])));
+
+                    uint32_t bits = static_cast<uint32_t>(_mm_movemask_epi8(m));
+                    if (!In)
+                        bits = ~bits & 0xffff;
+                    if (bits)
+                        return b + __builtin_ctz(bits);
+                }
+#endif
+            }
+
+            for(; b != e; ++b)
+                if (contains(*b) == In)
+                    return b;
+            return e;
+        }
+
+        uint64_t m_bitmap[4];
+        char     m_chars[8];
+        size_t   m_size;
+    };
+
+    // split a buffer the way more::getline() does: a run of delimiters ends
+    // a token and leading delimiters give an empty first token. The tokens
+    // are views into the buffer, nothing is copied: with escapes enabled
+    // they keep the backslashes, and unescape() gives the getline token...
+    //
+
+    class tokenizer
+    {
+    public:
+        tokenizer(std::string_view buf, std::string_view delim, bool esc = string_utils::escape_disabled)
+        : m_cur(buf.data())
+        , m_end(buf.data() + buf.size())
+        , m_delim(delim)
+        , m_stop(delim)
+        , m_esc(esc)
+        {
+            if (esc)
+                m_stop.insert('\\');
+        }
+
+        bool
+        next(std::string_view &token)
+        {
+            if (m_cur == m_end)
+                return false;
+
+            const char *e = m_stop.find(m_cur, m_end);
+
+            // an escaped char never ends the token
+            //
+            while (m_esc && e != m_end && *e == '\\')
+                e = m_stop.find(m_end - e > 2 ? e + 2 : m_end, m_end);
+
+            // a lone backslash at the end: getline extracts nothing
+            //
+            if (m_esc && e == m_end && e - m_cur == 1 && *m_cur == '\\') {
+                m_cur = m_end;
+                return false;
+            }
+
+            token = std::string_view(m_cur, static_cast<size_t>(e - m_cur));
+            m_cur = m_delim.find_not(e, m_end);
+            return true;
+        }
+
+        // what is left of the buffer
+        //
+        std::string_view
+        rest() const
+        {
+            return std::string_view(m_cur, static_cast<size_t>(m_end - m_cur));
+        }
+
+    private:
+        const char *m_cur;
+        const char *m_end;
+        char_set    m_delim;
+        char_set    m_stop;
+        bool        m_esc;
+    };
+
+    // the token of getline() with escapes from the one of the tokenizer
+    //
+
+    inline std::string
+    unescape(std::string_view token, std::string_view delim)
+    {
+        std::string ret;
+        ret.reserve(token.size());
+
+        for(size_t i = 0; i < token.size(); i++)
+        {
+            char c = token[i];
+            if (c == '\\') {
+                if (++i == token.size())
+                    break;
+                c = token[i];
+                if (delim.find(c) == std::string_view::npos && c != '\\')
+                    ret += '\\';
+            }
+            ret += c;
+        }
+
+        return ret;
+    }
+
+    // for(auto t : more::tokens(line, " ")): a tokenizer as a range
+    //
+
+    class token_range
+    {
+    public:
+        class iterator
+        {
+        public:
+            typedef std::input_iterator_tag iterator_category;
+            typedef std::string_view        value_type;
+            typedef std::ptrdiff_t          difference_type;
+            typedef const std::string_view *pointer;
+            typedef const std::string_view &reference;
+
+            iterator(const tokenizer &tok)
+            : m_tok(tok)
+            , m_value()
+            , m_end(false)
+            {
+                ++*this;
+            }
+
+            iterator()
+            : m_tok(std::string_view(), std::string_view())
+            , m_value()
+            , m_end(true)
+            {}
+
+            reference operator*() const { return m_value; }
+            pointer operator->() const  { return &m_value; }
+
+            iterator &
+            operator++()
+            {
+                m_end = !m_tok.next(m_value);
+                return *this;
+            }
+
+            iterator
+            operator++(int)
+            {
+                iterator ret(*this);
+                ++*this;
+                return ret;
+            }
+
+            bool
+            operator==(const iterator &other) const
+            {
+                return m_end == other.m_end && (m_end || m_value.data() == other.m_value.data());
+            }
+
+            bool
+            operator!=(const iterator &other) const
+            {
+                return !(*this == other);
+            }
+
+        private:
+            tokenizer        m_tok;
+            std::string_view m_value;
+            bool             m_end;
+        };
+
+        token_range(std::string_view str, std::string_view sep, bool esc = string_utils::escape_disabled)
+        : m_tok(str, sep, esc)
+        {}
+
+        iterator begin() const { return iterator(m_tok); }
+        iterator end() const   { return iterator(); }
+
+    private:
+        tokenizer m_tok;
+    };
+
+    inline token_range
+    tokens(std::string_view str, std::string_view sep, bool esc = string_utils::escape_disabled)
+    {
+        return token_range(str, sep, esc);
+    }
+
+    // split a string_view into a container of string_views (same tokens
+    // as more::split)
+    //
+
+    template<typename Iter>
+    inline void
+    split_view(std::string_view str, Iter out, std::string_view sep)
+    {
+        tokenizer tok(str, sep);
+        std::string_view token;
+        while (tok.next(token))
+            *out ++ = token;
+    }
+
     // split a string into a container 
     //
 
@@ -215,6 +508,31 @@ namespace more {
         return trim_copy(s,str,1);
     }
 
+    // trim a string_view (same result as trim_copy, without the copy)
+    //
+
+    inline std::string_view
+    trim_view(std::string_view s, std::string_view str = string_utils::white_space::value(char()), int lr = 0)
+    {
+        std::string_view::size_type b = lr > 0 ? std::string_view::npos : s.find_first_not_of(str);
+        std::string_view::size_type e = lr < 0 ? s.size() : s.find_last_not_of(str);
+        b = (b == std::string_view::npos ? 0 : b);
+        e = (e == std::string_view::npos ? 0 : e + 1);
+        return s.substr(b, e > b ? e - b : 0);
+    }
+
+    inline std::string_view
+    left_trim_view(std::string_view s, std::string_view str = string_utils::white_space::value(char()))
+    {
+        return trim_view(s, str, -1);
+    }
+
+    inline std::string_view
+    right_trim_view(std::string_view s, std::string_view str = string_utils::white_space::value(char()))
+    {
+        return trim_view(s, str, 1);
+    }
+
     // in-place trim
     //
 
@@ -0,0 +1,170 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <libifshow.hpp>
+
+#include <netlink/link.hpp>
+#include <snapshot/snapshot.hpp>
+
+#include <ifname.hpp>
+
+namespace libifshow {
+
+    const field *
+    interface::find(std::string_view key) const
+    {
+        auto it = std::lower_bound(fields.begin(), fields.end(), key, [](const field &f, std::string_view k) {
+                                    return f.key < k;
+                                  });
+        return it != fields.end() && it->key == key ? &*it : nullptr;
+    }
+
+
+    std::string_view
+    interface::get(std::string_view key) const
+    {
+        auto f = find(key);
+        return f ? std::string_view(f->value) : std::string_view();
+    }
+
+
+    uint64_t
+    interface::counter(std::string_view key) const
+    {
+        auto v = get(key);
+        uint64_t ret = 0;
+        std::from_chars(v.data(), v.data() + v.size(), ret);
+        return ret;
+    }
+
+
+    const interface *
+    snapshot::find(std::string_view name) const
+    {
+        auto it = std::lower_bound(interfaces.begin(), interfaces.end(), name, [](const interface &i, std::string_view n) {
+                                    return i.name < n;
+                                  });
+        return it != interfaces.end() && it->name == name ? &*it : nullptr;
+    }
+
+
+    struct collector::impl
+    {
+        std::vector<ifshow::ifname> selection;
+        snapshot                    snap;
+        bool                        valid;
+        uint64_t                    generation;
+    };
+
+
+    collector::collector(std::vector<std::string> ifnames)
+    : m_impl(new impl{ {}, {}, false, 0 })
+    {
+        for(auto &name : ifnames)
+            m_impl->selection.emplace_back(name);
+    }
+
+    collector::~collector() = default;
+
+    collector::collector(collector &&) noexcept = default;
+    collector& collector::operator=(collector &&) noexcept = default;
+
+
+    void
+    collector::invalidate()
+    {
+        m_impl->valid = false;
+    }
+
+
+    const snapshot &
+    collector::sample()
+    {
+        using namespace ifshow;
+
+        auto &m = *m_impl;
+
+        // a single dump: the interfaces that exist and their counters
+        //
+        auto links = netlink::get_links();
+
+        std::unordered_map<ifname, const netlink::link *> by_name;
+        for(auto &l : links)
+            by_name.emplace(l.name, &l);
+
+        std::vector<ifname> names;
+        if (m.selection.empty()) {
+            for(auto &l : links)
+                names.push_back(l.name);
+        }
+        else {
+            for(auto &name : m.selection)
+                if (by_name.count(name))
+                    names.push_back(name);
+        }
+
+        std::sort(names.begin(), names.end());
+        names.erase(std::unique(names.begin(), names.end()), names.end());
+
+        // the interfaces are the same: only the counters change
+        //
+        bool same = m.valid && names.size() == m.snap.interfaces.size() &&
+                    std::equal(names.begin(), names.end(), m.snap.interfaces.begin(), [](const ifname &n, const interface &i) {
+                        return n.view() == i.name;
+                    });
+
+        if (same)
+        {
+            for(auto &i : m.snap.interfaces)
+            {
+                auto &l = *by_name.at(ifname(i.name));
+
+                // deleted and created again with the same name: a new device
+                //
+                if (i.counter("ifindex") != static_cast<uint64_t>(l.index)) {
+                    auto fresh = ifshow::snapshot::collect({ ifname(i.name) });
+                    if (!fresh.interfaces.empty()) {
+                        i = std::move(fresh.interfaces.front());
+                        continue;
+                    }
+                }
+
+                ifshow::snapshot::refresh_counters(i, l);
+            }
+
+            m.snap.time = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+        else
+        {
+            m.snap  = ifshow::snapshot::collect(names);
+            m.valid = true;
+        }
+
+        m.snap.generation = ++m.generation;
+        return m.snap;
+    }
+
+} // namespace libifshow
+
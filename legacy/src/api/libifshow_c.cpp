@@ -0,0 +1,201 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <exception>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <libifshow.h>
+#include <libifshow.hpp>
+
+struct ifshow_collector
+{
+    libifshow::collector    collector;
+    std::string             error;
+};
+
+// ifshow_snapshot is an opaque handle to a libifshow::snapshot
+//
+static inline const libifshow::snapshot &
+snap(const ifshow_snapshot *s)
+{
+    return *reinterpret_cast<const libifshow::snapshot *>(s);
+}
+
+
+static inline const libifshow::interface *
+iface(const ifshow_snapshot *s, size_t i)
+{
+    return s && i < snap(s).interfaces.size() ? &snap(s).interfaces[i] : nullptr;
+}
+
+
+extern "C" {
+
+ifshow_collector *
+ifshow_collector_new(const char * const *ifnames, size_t n)
+{
+    if (n && !ifnames)
+        return nullptr;
+
+    try
+    {
+        std::vector<std::string> names;
+        for(size_t i = 0; i < n; i++)
+        {
+            if (!ifnames[i])
+                return nullptr;
+            names.emplace_back(ifnames[i]);
+        }
+
+        return new ifshow_collector{ libifshow::collector(std::move(names)), std::string() };
+    }
+    catch(std::exception &)
+    {
+        return nullptr;
+    }
+}
+
+
+void
+ifshow_collector_free(ifshow_collector *c)
+{
+    delete c;
+}
+
+
+const char *
+ifshow_error(const ifshow_collector *c)
+{
+    return c ? c->error.c_str() : "";
+}
+
+
+const ifshow_snapshot *
+ifshow_sample(ifshow_collector *c)
+{
+    if (!c)
+        return nullptr;
+
+    try
+    {
+        c->error.clear();
+        return reinterpret_cast<const ifshow_snapshot *>(&c->collector.sample());
+    }
+    catch(std::exception &e)
+    {
+        c->error = e.what();
+        return nullptr;
+    }
+}
+
+
+void
+ifshow_invalidate(ifshow_collector *c)
+{
+    if (c)
+        c->collector.invalidate();
+}
+
+
+double
+ifshow_snapshot_time(const ifshow_snapshot *s)
+{
+    return s ? snap(s).time : 0;
+}
+
+
+uint64_t
+ifshow_snapshot_generation(const ifshow_snapshot *s)
+{
+    return s ? snap(s).generation : 0;
+}
+
+
+size_t
+ifshow_snapshot_interfaces(const ifshow_snapshot *s)
+{
+    return s ? snap(s).interfaces.size() : 0;
+}
+
+
+long
+ifshow_snapshot_find(const ifshow_snapshot *s, const char *ifname)
+{
+    if (!s || !ifname)
+        return -1;
+    auto i = snap(s).find(ifname);
+    return i ? static_cast<long>(i - snap(s).interfaces.data()) : -1;
+}
+
+
+const char *
+ifshow_interface_name(const ifshow_snapshot *s, size_t i)
+{
+    auto x = iface(s, i);
+    return x ? x->name.c_str() : nullptr;
+}
+
+
+size_t
+ifshow_interface_fields(const ifshow_snapshot *s, size_t i)
+{
+    auto x = iface(s, i);
+    return x ? x->fields.size() : 0;
+}
+
+
+const char *
+ifshow_interface_key(const ifshow_snapshot *s, size_t i, size_t f)
+{
+    auto x = iface(s, i);
+    return x && f < x->fields.size() ? x->fields[f].key.c_str() : nullptr;
+}
+
+
+const char *
+ifshow_interface_value(const ifshow_snapshot *s, size_t i, size_t f)
+{
+    auto x = iface(s, i);
+    return x && f < x->fields.size() ? x->fields[f].value.c_str() : nullptr;
+}
+
+
+const char *
+ifshow_interface_get(const ifshow_snapshot *s, size_t i, const char *key)
+{
+    auto x = iface(s, i);
+    auto f = x && key ? x->find(key) : nullptr;
+    return f ? f->value.c_str() : nullptr;
+}
+
+
+int
+ifshow_interface_counter(const ifshow_snapshot *s, size_t i, const char *key, uint64_t *value)
+{
+    auto x = iface(s, i);
+    if (!x || !key || !value || !x->find(key))
+        return -1;
+    *value = x->counter(key);
+    return 0;
+}
+
+} // extern "C"
+
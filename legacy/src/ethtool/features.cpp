@@ -0,0 +1,190 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#include <linux/ethtool_netlink.h>
+
+#include <cstring>
+#include <utility>
+
+#include <ethtool/features.hpp>
+#include <ethtool/netlink.hpp>
+
+#include <ifr.hpp>
+
+namespace ifshow { namespace ethtool {
+
+    // the ethtool -K names of the common features
+    //
+    static const std::pair<const char *, const char *> aliases[] =
+    {
+        { "sg",     "tx-scatter-gather"         },
+        { "tso",    "tx-tcp-segmentation"       },
+        { "gso",    "tx-generic-segmentation"   },
+        { "gro",    "rx-gro"                    },
+        { "lro",    "rx-lro"                    },
+        { "rx",     "rx-checksum"               },
+        { "rxhash", "rx-hashing"                },
+        { "rxvlan", "rx-vlan-hw-parse"          },
+        { "txvlan", "tx-vlan-hw-insert"         },
+        { "ntuple", "rx-ntuple-filter"          },
+    };
+
+
+    struct feature_table
+    {
+        std::vector<std::string> names;
+        std::unordered_map<std::string, int> index;
+        std::vector<std::string> alias;
+
+        feature_table()
+        {
+            // any interface returns the same set: loopback always exists
+            //
+            try
+            {
+                ifr lo("lo");
+                names = lo.ethtool_strings(ETH_SS_FEATURES, lo.ethtool_sset_count(ETH_SS_FEATURES));
+            }
+            catch(std::exception &)
+            {
+            }
+
+            alias.resize(names.size());
+
+            for(size_t i = 0; i < names.size(); i++)
+                index.emplace(names[i], static_cast<int>(i));
+
+            for(auto &a : aliases)
+            {
+                auto it = index.find(a.second);
+                if (it != index.end()) {
+                    alias[it->second] = a.first;
+                    index.emplace(a.first, it->second);
+                }
+            }
+        }
+    };
+
+
+    static const feature_table &
+    table()
+    {
+        static feature_table t;
+        return t;
+    }
+
+
+    const std::vector<std::string> &
+    feature_names()
+    {
+        return table().names;
+    }
+
+
+    int
+    feature_index(const std::string &name)
+    {
+        auto &t = table();
+        auto it = t.index.find(name);
+        return it == t.index.end() ? -1 : it->second;
+    }
+
+
+    std::string
+    feature_alias(size_t bit)
+    {
+        auto &t = table();
+        return bit < t.alias.size() ? t.alias[bit] : std::string();
+    }
+
+
+    // a compact bitset (ETHTOOL_A_BITSET_VALUE, u32 words)
+    //
+    static std::vector<uint32_t>
+    bitset_value(const attributes &a, int type)
+    {
+        auto value = a.nested(type, ETHTOOL_A_BITSET_MAX)[ETHTOOL_A_BITSET_VALUE];
+        if (!value)
+            return std::vector<uint32_t>();
+
+        std::vector<uint32_t> ret(payload_len(value) / sizeof(uint32_t));
+        memcpy(ret.data(), payload(value), ret.size() * sizeof(uint32_t));
+        return ret;
+    }
+
+
+    std::unordered_map<ifname, feature_set>
+    get_features(const std::vector<ifname> &ifnames)
+    {
+        std::unordered_map<ifname, feature_set> ret;
+
+        if (has_netlink())
+        {
+            std::unordered_map<ifname, feature_set> all;
+
+            try
+            {
+                dump(ETHTOOL_MSG_FEATURES_GET, ETHTOOL_A_FEATURES_HEADER, ETHTOOL_A_FEATURES_MAX,
+                     [&](const std::string &name, const attributes &a)
+                     {
+                         auto &f = all[name];
+                         f.available     = bitset_value(a, ETHTOOL_A_FEATURES_HW);
+                         f.requested     = bitset_value(a, ETHTOOL_A_FEATURES_WANTED);
+                         f.active        = bitset_value(a, ETHTOOL_A_FEATURES_ACTIVE);
+                         f.never_changed = bitset_value(a, ETHTOOL_A_FEATURES_NOCHANGE);
+                     }, ETHTOOL_FLAG_COMPACT_BITSETS);
+
+                for(auto &name : ifnames)
+                {
+                    auto it = all.find(name);
+                    if (it != all.end())
+                        ret.emplace(name, std::move(it->second));
+                }
+                return ret;
+            }
+            catch(std::system_error &)
+            {
+            }
+        }
+
+        uint32_t blocks = static_cast<uint32_t>((feature_names().size() + 31) / 32);
+        if (!blocks)
+            return ret;
+
+        for(auto &name : ifnames)
+        {
+            auto res = ifr(name).try_features(blocks);
+            if (!res)
+                continue;
+
+            auto &f = ret[name];
+            for(auto &b : *res)
+            {
+                f.available.push_back(b.available);
+                f.requested.push_back(b.requested);
+                f.active.push_back(b.active);
+                f.never_changed.push_back(b.never_changed);
+            }
+        }
+
+        return ret;
+    }
+
+} // namespace ethtool
+} // namespace ifshow
+
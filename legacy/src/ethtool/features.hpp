@@ -0,0 +1,68 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <ifname.hpp>
+
+namespace ifshow { namespace ethtool {
+
+    // the offload features of an interface (one bit per feature name)
+    //
+    struct feature_set
+    {
+        std::vector<uint32_t> available;        // can be changed
+        std::vector<uint32_t> requested;        // asked by the user
+        std::vector<uint32_t> active;
+        std::vector<uint32_t> never_changed;    // fixed
+
+        static bool
+        test(const std::vector<uint32_t> &set, size_t bit)
+        {
+            return bit / 32 < set.size() && (set[bit / 32] >> (bit % 32)) & 1;
+        }
+    };
+
+    // the names of the features (ETH_SS_FEATURES), the same for every
+    // interface: read once per run
+    //
+    extern const std::vector<std::string> &feature_names();
+
+    // the bit of a feature by name ("rx-gro") or by its ethtool -K short
+    // name ("gro", "tso"...), -1 if unknown
+    //
+    extern int feature_index(const std::string &name);
+
+    // the short name of a feature if it has one ("rx-gro" -> "gro")
+    //
+    extern std::string feature_alias(size_t bit);
+
+    // the features of the given interfaces: a single netlink dump
+    // (FEATURES_GET), or ETHTOOL_GFEATURES per interface on older kernels
+    //
+    extern std::unordered_map<ifname, feature_set>
+    get_features(const std::vector<ifname> &ifnames);
+
+} // namespace ethtool
+} // namespace ifshow
+
@@ -0,0 +1,313 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <linux/genetlink.h>
+#include <linux/ethtool_netlink.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+
+#include <ethtool/netlink.hpp>
+
+namespace ifshow { namespace ethtool {
+
+    attributes::attributes(const void *data, size_t len, int max)
+    : m_table(static_cast<size_t>(max) + 1, nullptr)
+    {
+        auto p = static_cast<const char *>(data);
+
+        while (len >= NLA_HDRLEN)
+        {
+            auto nla = reinterpret_cast<const struct nlattr *>(p);
+            if (nla->nla_len < NLA_HDRLEN || nla->nla_len > len)
+                break;
+
+            int type = nla->nla_type & NLA_TYPE_MASK;
+            if (type <= max)
+                m_table[type] = nla;
+
+            size_t step = std::min<size_t>(NLA_ALIGN(nla->nla_len), len);
+            p += step;
+            len -= step;
+        }
+    }
+
+
+    const void *
+    payload(const struct nlattr *nla)
+    {
+        return reinterpret_cast<const char *>(nla) + NLA_HDRLEN;
+    }
+
+
+    size_t
+    payload_len(const struct nlattr *nla)
+    {
+        return nla->nla_len - NLA_HDRLEN;
+    }
+
+
+    uint32_t
+    attributes::u32(int type, uint32_t def) const
+    {
+        auto nla = (*this)[type];
+        if (!nla || payload_len(nla) < sizeof(uint32_t))
+            return def;
+        uint32_t ret;
+        memcpy(&ret, payload(nla), sizeof(ret));
+        return ret;
+    }
+
+
+    uint8_t
+    attributes::u8(int type, uint8_t def) const
+    {
+        auto nla = (*this)[type];
+        if (!nla || payload_len(nla) < 1)
+            return def;
+        return *static_cast<const uint8_t *>(payload(nla));
+    }
+
+
+    std::string
+    attributes::str(int type) const
+    {
+        auto nla = (*this)[type];
+        if (!nla)
+            return std::string();
+        auto s = static_cast<const char *>(payload(nla));
+        return std::string(s, strnlen(s, payload_len(nla)));
+    }
+
+
+    attributes
+    attributes::nested(int type, int max) const
+    {
+        auto nla = (*this)[type];
+        if (!nla)
+            return attributes(nullptr, 0, max);
+        return attributes(payload(nla), payload_len(nla), max);
+    }
+
+
+    // one socket per thread: the replies are read by the thread that sent
+    // the request (libifshow collectors may be sampled concurrently)
+    //
+    struct socket_
+    {
+        int fd, error;
+
+        socket_()
+        : fd(socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_GENERIC))
+        , error(fd == -1 ? errno : 0)
+        {}
+
+        ~socket_()
+        {
+            if (fd != -1)
+                ::close(fd);
+        }
+    };
+
+
+    static int
+    sock_()
+    {
+        thread_local socket_ sock;
+        if (sock.fd == -1)
+            throw std::system_error(sock.error, std::generic_category());
+        return sock.fd;
+    }
+
+
+    // send a request and call fun for every reply of type, up to the ack
+    // (or NLMSG_DONE for a dump)
+    //
+    static void
+    transact(struct nlmsghdr *req, uint16_t type, const std::function<void(const struct nlmsghdr *)> &fun)
+    {
+        static std::atomic<unsigned int> seq;
+
+        req->nlmsg_seq = ++seq;
+        req->nlmsg_flags |= NLM_F_REQUEST | NLM_F_ACK;
+
+        if (send(sock_(), req, req->nlmsg_len, 0) == -1)
+            throw std::system_error(errno, std::generic_category());
+
+        // large enough for any dump chunk the kernel sends
+        //
+        alignas(struct nlmsghdr) char buf[32768];
+
+        for(;;)
+        {
+            ssize_t n = recv(sock_(), buf, sizeof(buf), 0);
+            if (n == -1) {
+                if (errno == EINTR)
+                    continue;
+                throw std::system_error(errno, std::generic_category());
+            }
+
+            int len = static_cast<int>(n);
+            for(auto nlh = reinterpret_cast<struct nlmsghdr *>(buf); NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len))
+            {
+                if (nlh->nlmsg_seq != req->nlmsg_seq)
+                    continue;
+
+                if (nlh->nlmsg_type == NLMSG_DONE)
+                    return;
+
+                if (nlh->nlmsg_type == NLMSG_ERROR) {
+                    auto err = static_cast<const struct nlmsgerr *>(NLMSG_DATA(nlh));
+                    if (err->error)
+                        throw std::system_error(-err->error, std::generic_category());
+                    return;
+                }
+
+                if (nlh->nlmsg_type == type)
+                    fun(nlh);
+            }
+        }
+    }
+
+
+    // the attributes following the genetlink header
+    //
+    static attributes
+    genl_attributes(const struct nlmsghdr *nlh, int max)
+    {
+        size_t hdr = NLMSG_LENGTH(GENL_HDRLEN);
+        if (nlh->nlmsg_len < hdr)
+            return attributes(nullptr, 0, max);
+        return attributes(reinterpret_cast<const char *>(nlh) + hdr, nlh->nlmsg_len - hdr, max);
+    }
+
+
+    // the id of the ethtool family, resolved once (0 if not available)
+    //
+    static uint16_t
+    family()
+    {
+        static std::atomic<int> id(-1);
+        if (id != -1)
+            return static_cast<uint16_t>(id);
+
+        // threads racing here resolve the same id
+        //
+        int ret = 0;
+
+        struct {
+            struct nlmsghdr  nlh;
+            struct genlmsghdr genl;
+            char             attrs[NLA_HDRLEN + NLA_ALIGN(sizeof(ETHTOOL_GENL_NAME))];
+        } req;
+
+        memset(&req, 0, sizeof(req));
+        req.nlh.nlmsg_len   = NLMSG_LENGTH(GENL_HDRLEN + NLA_HDRLEN + sizeof(ETHTOOL_GENL_NAME));
+        req.nlh.nlmsg_type  = GENL_ID_CTRL;
+        req.genl.cmd        = CTRL_CMD_GETFAMILY;
+        req.genl.version    = 1;
+
+        auto nla = reinterpret_cast<struct nlattr *>(req.attrs);
+        nla->nla_type = CTRL_ATTR_FAMILY_NAME;
+        nla->nla_len  = NLA_HDRLEN + sizeof(ETHTOOL_GENL_NAME);
+        memcpy(req.attrs + NLA_HDRLEN, ETHTOOL_GENL_NAME, sizeof(ETHTOOL_GENL_NAME));
+
+        try
+        {
+            transact(&req.nlh, GENL_ID_CTRL, [&](const struct nlmsghdr *nlh) {
+                ret = genl_attributes(nlh, CTRL_ATTR_MAX).u32(CTRL_ATTR_FAMILY_ID) & 0xffff;
+            });
+        }
+        catch(std::system_error &)
+        {
+            // ENOENT: the kernel has no ethtool netlink interface
+        }
+
+        id = ret;
+
+        // CTRL_ATTR_FAMILY_ID is a u16
+        //
+        return static_cast<uint16_t>(ret);
+    }
+
+
+    bool
+    has_netlink()
+    {
+        try
+        {
+            return family() != 0;
+        }
+        catch(std::system_error &)
+        {
+            return false;
+        }
+    }
+
+
+    void
+    dump(uint8_t cmd, int header, int max, const std::function<void(const std::string &, const attributes &)> &fun,
+         uint32_t flags)
+    {
+        struct {
+            struct nlmsghdr  nlh;
+            struct genlmsghdr genl;
+            struct nlattr    header;
+            struct nlattr    flags;
+            uint32_t         flags_value;
+        } req;
+
+        memset(&req, 0, sizeof(req));
+        req.nlh.nlmsg_len   = NLMSG_LENGTH(GENL_HDRLEN + NLA_HDRLEN);
+        req.nlh.nlmsg_type  = family();
+        req.nlh.nlmsg_flags = NLM_F_DUMP;
+        req.genl.cmd        = cmd;
+        req.genl.version    = ETHTOOL_GENL_VERSION;
+
+        // a header nest with no device: all the devices
+        //
+        req.header.nla_type = static_cast<uint16_t>(header | NLA_F_NESTED);
+        req.header.nla_len  = NLA_HDRLEN;
+
+        if (flags) {
+            req.flags.nla_type  = ETHTOOL_A_HEADER_FLAGS;
+            req.flags.nla_len   = NLA_HDRLEN + sizeof(uint32_t);
+            req.flags_value     = flags;
+            req.header.nla_len += NLA_HDRLEN + sizeof(uint32_t);
+            req.nlh.nlmsg_len  += NLA_HDRLEN + sizeof(uint32_t);
+        }
+
+        if (!req.nlh.nlmsg_type)
+            throw std::system_error(EOPNOTSUPP, std::generic_category());
+
+        transact(&req.nlh, req.nlh.nlmsg_type, [&](const struct nlmsghdr *nlh) {
+            auto attrs = genl_attributes(nlh, max);
+            auto name  = attrs.nested(header, ETHTOOL_A_HEADER_MAX).str(ETHTOOL_A_HEADER_DEV_NAME);
+            fun(name, attrs);
+        });
+    }
+
+} // namespace ethtool
+} // namespace ifshow
+
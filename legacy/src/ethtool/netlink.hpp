@@ -0,0 +1,80 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#pragma once
+
+#include <linux/netlink.h>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ifshow { namespace ethtool {
+
+    /*
+     * a minimal client of the ethtool generic netlink family (kernel 5.6+):
+     * a single dump returns the settings of all the interfaces, where the
+     * ioctls need one call per interface.
+     */
+
+    // the attributes of a message (or of a nest), indexed by type
+    //
+    class attributes
+    {
+    public:
+        attributes(const void *data, size_t len, int max);
+
+        const struct nlattr *
+        operator[](int type) const
+        {
+            return type < static_cast<int>(m_table.size()) ? m_table[type] : nullptr;
+        }
+
+        uint32_t u32(int type, uint32_t def = 0) const;
+        uint8_t  u8(int type, uint8_t def = 0) const;
+        std::string str(int type) const;
+
+        // the attributes of a nest
+        //
+        attributes nested(int type, int max) const;
+
+    private:
+        std::vector<const struct nlattr *> m_table;
+    };
+
+    // the ethtool family is available (the ioctls are used otherwise)
+    //
+    extern bool has_netlink();
+
+    // dump cmd for all the interfaces: fun is called with the interface
+    // name (from the header nest) and the attributes of each reply.
+    // flags are the ETHTOOL_FLAG_* of the request header
+    //
+    extern void dump(uint8_t cmd, int header, int max,
+                     const std::function<void(const std::string &, const attributes &)> &fun,
+                     uint32_t flags = 0);
+
+    // the payload of an attribute
+    //
+    extern const void *payload(const struct nlattr *nla);
+    extern size_t payload_len(const struct nlattr *nla);
+
+} // namespace ethtool
+} // namespace ifshow
+
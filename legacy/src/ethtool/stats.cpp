@@ -0,0 +1,196 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <numeric>
+
+#include <ethtool/stats.hpp>
+
+namespace ifshow { namespace ethtool {
+
+    static bool
+    is_sep(char c)
+    {
+        return c == '_' || c == '-' || c == '.' || c == ':' || c == ' ';
+    }
+
+    static bool
+    ends_with(const std::string &s, size_t end, const char *suffix)
+    {
+        size_t len = strlen(suffix);
+        return end >= len && s.compare(end - len, len, suffix) == 0;
+    }
+
+    static std::string
+    make_label(std::string prefix, std::string suffix)
+    {
+        while (!prefix.empty() && is_sep(prefix.back()))
+            prefix.pop_back();
+
+        size_t b = suffix.find_first_not_of("_-.: ");
+        suffix.erase(0, b == std::string::npos ? suffix.size() : b);
+
+        if (prefix.empty())
+            return suffix;
+        if (suffix.empty())
+            return prefix;
+
+        // rx-0.rx_bytes -> rx_bytes
+        //
+        if (suffix.compare(0, prefix.size(), prefix) == 0 &&
+            suffix.size() > prefix.size() && is_sep(suffix[prefix.size()]))
+            return suffix;
+
+        return prefix + '_' + suffix;
+    }
+
+    /*
+     * find the queue index in a driver counter name. The common layouts are:
+     *
+     *  rx_queue_0_packets, queue_0_tx_cnt      (virtio_net, ixgbe, ena)
+     *  rx0_packets, txq0_pktnum, ch0_events    (mlx5, hns3)
+     *  rx-0.rx_packets                         (i40e, sfc)
+     *  [0]: rx_ucast_packets                   (bnxt)
+     *
+     * Numbers following "rx_" or "tx_" are not queues (rx_64_bytes_phy).
+     */
+
+    // the queue number starting at name[b] (driver supplied: a number out
+    // of range is not a queue)
+    //
+    static bool
+    parse_queue(const std::string &name, size_t b, size_t e, int &queue)
+    {
+        auto r = std::from_chars(name.data() + b, name.data() + e, queue);
+        return r.ec == std::errc();
+    }
+
+
+    static int
+    split_queue(const std::string &name, std::string &label)
+    {
+        int id;
+
+        if (name.size() > 2 && name[0] == '[' && isdigit(name[1]))
+        {
+            size_t e = name.find(']');
+            if (e != std::string::npos && parse_queue(name, 1, e, id)) {
+                label = make_label(std::string(), name.substr(e + 1));
+                return id;
+            }
+        }
+
+        for(size_t b = 0; b < name.size(); b++)
+        {
+            if (!isdigit(name[b]))
+                continue;
+
+            size_t e = b;
+            while (e < name.size() && isdigit(name[e]))
+                e++;
+
+            if (e == name.size() || is_sep(name[e]))
+            {
+                bool queue = false;
+                size_t p = b;
+
+                if (ends_with(name, b, "queue") || ends_with(name, b, "queue_") || ends_with(name, b, "queue-")) {
+                    p = name.rfind("queue", b);
+                    queue = true;
+                }
+                else if (ends_with(name, b, "rx-") || ends_with(name, b, "tx-")) {
+                    p = b - 1;
+                    queue = true;
+                }
+                else if (ends_with(name, b, "rx") || ends_with(name, b, "tx") ||
+                         ends_with(name, b, "q")  || ends_with(name, b, "ch")) {
+                    queue = true;
+                }
+
+                if (queue && parse_queue(name, b, e, id)) {
+                    label = make_label(name.substr(0, p), name.substr(e));
+                    return id;
+                }
+            }
+
+            b = e;
+        }
+
+        label = name;
+        return -1;
+    }
+
+
+    std::shared_ptr<const stats_layout>
+    get_stats_layout(const ifr &iif, const ethtool_drvinfo &info)
+    {
+        static std::mutex mutex;
+        static std::map<std::string, std::shared_ptr<const stats_layout>> cache;
+
+        std::string key = std::string(info.driver) + '\0' + info.fw_version + '\0' + std::to_string(info.n_stats);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = cache.find(key);
+            if (it != cache.end())
+                return it->second;
+        }
+
+        auto layout = std::make_shared<stats_layout>();
+
+        uint32_t n = iif.ethtool_sset_count(ETH_SS_STATS);
+
+        layout->name = iif.ethtool_strings(ETH_SS_STATS, n);
+        layout->label.resize(layout->name.size());
+        layout->queue.resize(layout->name.size());
+        layout->max_queue = -1;
+
+        for(size_t i = 0; i < layout->name.size(); i++)
+        {
+            layout->queue[i] = split_queue(layout->name[i], layout->label[i]);
+            layout->max_queue = std::max(layout->max_queue, layout->queue[i]);
+        }
+
+        layout->order.resize(layout->name.size());
+        std::iota(layout->order.begin(), layout->order.end(), 0);
+        std::stable_sort(layout->order.begin(), layout->order.end(), [&](size_t a, size_t b) {
+                            return layout->queue[a] < layout->queue[b];
+                         });
+
+        std::lock_guard<std::mutex> lock(mutex);
+        return cache.emplace(key, std::move(layout)).first->second;
+    }
+
+
+    std::vector<uint64_t>
+    get_stats(const ifr &iif, const stats_layout &layout)
+    {
+        std::vector<uint64_t> ret(layout.size());
+        iif.ethtool_stats(ret.data(), static_cast<uint32_t>(ret.size()));
+        return ret;
+    }
+
+} // namespace ethtool
+} // namespace ifshow
+
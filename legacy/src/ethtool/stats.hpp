@@ -0,0 +1,66 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <linux/ethtool.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ifr.hpp>
+
+namespace ifshow { namespace ethtool {
+
+    /*
+     * names of the driver statistics (ETH_SS_STATS) and their grouping by
+     * queue: queue[i] is -1 for device-wide counters, label[i] is the name
+     * with the queue index removed (e.g. rx_queue_3_packets -> rx_packets)
+     * and order lists the indices grouped by queue, device-wide ones first
+     */
+
+    struct stats_layout
+    {
+        std::vector<std::string> name;
+        std::vector<std::string> label;
+        std::vector<int>         queue;
+        std::vector<size_t>      order;
+        int                      max_queue;
+
+        size_t
+        size() const
+        {
+            return name.size();
+        }
+    };
+
+    // the layout is cached per (driver, firmware, n_stats), so that repeated
+    // lookups only cost a map access and samples only transfer the values
+    //
+    extern std::shared_ptr<const stats_layout>
+    get_stats_layout(const ifr &iif, const ethtool_drvinfo &info);
+
+    extern std::vector<uint64_t>
+    get_stats(const ifr &iif, const stats_layout &layout);
+
+} // namespace ethtool
+} // namespace ifshow
+
@@ -0,0 +1,182 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#include <linux/ethtool_netlink.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+#include <ethtool/netlink.hpp>
+#include <ethtool/tuning.hpp>
+
+#include <ifr.hpp>
+
+namespace ifshow { namespace ethtool {
+
+    static void
+    dump_rings(std::unordered_map<ifname, tuning> &ret)
+    {
+        dump(ETHTOOL_MSG_RINGS_GET, ETHTOOL_A_RINGS_HEADER, ETHTOOL_A_RINGS_MAX, [&](const std::string &name, const attributes &a)
+        {
+            auto it = ret.find(name);
+            if (it == ret.end())
+                return;
+
+            ethtool_ringparam r;
+            memset(&r, 0, sizeof(r));
+            r.cmd                   = ETHTOOL_GRINGPARAM;
+            r.rx_max_pending        = a.u32(ETHTOOL_A_RINGS_RX_MAX);
+            r.rx_mini_max_pending   = a.u32(ETHTOOL_A_RINGS_RX_MINI_MAX);
+            r.rx_jumbo_max_pending  = a.u32(ETHTOOL_A_RINGS_RX_JUMBO_MAX);
+            r.tx_max_pending        = a.u32(ETHTOOL_A_RINGS_TX_MAX);
+            r.rx_pending            = a.u32(ETHTOOL_A_RINGS_RX);
+            r.rx_mini_pending       = a.u32(ETHTOOL_A_RINGS_RX_MINI);
+            r.rx_jumbo_pending      = a.u32(ETHTOOL_A_RINGS_RX_JUMBO);
+            r.tx_pending            = a.u32(ETHTOOL_A_RINGS_TX);
+            it->second.rings = r;
+        });
+    }
+
+
+    static void
+    dump_coalesce(std::unordered_map<ifname, tuning> &ret)
+    {
+        dump(ETHTOOL_MSG_COALESCE_GET, ETHTOOL_A_COALESCE_HEADER, ETHTOOL_A_COALESCE_MAX, [&](const std::string &name, const attributes &a)
+        {
+            auto it = ret.find(name);
+            if (it == ret.end())
+                return;
+
+            ethtool_coalesce c;
+            memset(&c, 0, sizeof(c));
+            c.cmd                       = ETHTOOL_GCOALESCE;
+            c.rx_coalesce_usecs         = a.u32(ETHTOOL_A_COALESCE_RX_USECS);
+            c.rx_max_coalesced_frames   = a.u32(ETHTOOL_A_COALESCE_RX_MAX_FRAMES);
+            c.rx_coalesce_usecs_irq     = a.u32(ETHTOOL_A_COALESCE_RX_USECS_IRQ);
+            c.rx_max_coalesced_frames_irq = a.u32(ETHTOOL_A_COALESCE_RX_MAX_FRAMES_IRQ);
+            c.tx_coalesce_usecs         = a.u32(ETHTOOL_A_COALESCE_TX_USECS);
+            c.tx_max_coalesced_frames   = a.u32(ETHTOOL_A_COALESCE_TX_MAX_FRAMES);
+            c.tx_coalesce_usecs_irq     = a.u32(ETHTOOL_A_COALESCE_TX_USECS_IRQ);
+            c.tx_max_coalesced_frames_irq = a.u32(ETHTOOL_A_COALESCE_TX_MAX_FRAMES_IRQ);
+            c.stats_block_coalesce_usecs = a.u32(ETHTOOL_A_COALESCE_STATS_BLOCK_USECS);
+            c.use_adaptive_rx_coalesce  = a.u8(ETHTOOL_A_COALESCE_USE_ADAPTIVE_RX);
+            c.use_adaptive_tx_coalesce  = a.u8(ETHTOOL_A_COALESCE_USE_ADAPTIVE_TX);
+            c.pkt_rate_low              = a.u32(ETHTOOL_A_COALESCE_PKT_RATE_LOW);
+            c.pkt_rate_high             = a.u32(ETHTOOL_A_COALESCE_PKT_RATE_HIGH);
+            c.rate_sample_interval      = a.u32(ETHTOOL_A_COALESCE_RATE_SAMPLE_INTERVAL);
+            it->second.coalesce = c;
+        });
+    }
+
+
+    static void
+    dump_channels(std::unordered_map<ifname, tuning> &ret)
+    {
+        dump(ETHTOOL_MSG_CHANNELS_GET, ETHTOOL_A_CHANNELS_HEADER, ETHTOOL_A_CHANNELS_MAX, [&](const std::string &name, const attributes &a)
+        {
+            auto it = ret.find(name);
+            if (it == ret.end())
+                return;
+
+            ethtool_channels c;
+            memset(&c, 0, sizeof(c));
+            c.cmd               = ETHTOOL_GCHANNELS;
+            c.max_rx            = a.u32(ETHTOOL_A_CHANNELS_RX_MAX);
+            c.max_tx            = a.u32(ETHTOOL_A_CHANNELS_TX_MAX);
+            c.max_other         = a.u32(ETHTOOL_A_CHANNELS_OTHER_MAX);
+            c.max_combined      = a.u32(ETHTOOL_A_CHANNELS_COMBINED_MAX);
+            c.rx_count          = a.u32(ETHTOOL_A_CHANNELS_RX_COUNT);
+            c.tx_count          = a.u32(ETHTOOL_A_CHANNELS_TX_COUNT);
+            c.other_count       = a.u32(ETHTOOL_A_CHANNELS_OTHER_COUNT);
+            c.combined_count    = a.u32(ETHTOOL_A_CHANNELS_COMBINED_COUNT);
+            it->second.channels = c;
+        });
+    }
+
+
+    // the ioctls, one thread per slice of the interfaces: the time is
+    // bound by the slowest drivers (some take the rtnl lock or talk to the
+    // firmware), not by their sum
+    //
+    static void
+    ioctl_tuning(const std::vector<ifname> &ifnames, std::unordered_map<ifname, tuning> &ret)
+    {
+        std::vector<tuning *> slot;
+        for(auto &name : ifnames)
+            slot.push_back(&ret[name]);
+
+        std::atomic<size_t> next(0);
+
+        auto worker = [&] {
+            for(size_t n; (n = next++) < ifnames.size(); )
+            {
+                ifr iif(ifnames[n]);
+                slot[n]->rings    = iif.try_ringparam();
+                slot[n]->coalesce = iif.try_coalesce();
+                slot[n]->channels = iif.try_channels();
+            }
+        };
+
+        size_t threads = std::min<size_t>({ ifnames.size(), 8, std::max(1u, std::thread::hardware_concurrency()) });
+
+        std::vector<std::thread> pool;
+        for(size_t i = 1; i < threads; i++)
+            pool.emplace_back(worker);
+
+        worker();
+
+        for(auto &t : pool)
+            t.join();
+    }
+
+
+    std::unordered_map<ifname, tuning>
+    get_tuning(const std::vector<ifname> &ifnames)
+    {
+        std::unordered_map<ifname, tuning> ret;
+
+        if (has_netlink())
+        {
+            for(auto &name : ifnames)
+                ret.emplace(name, tuning());
+
+            // the interfaces whose driver lacks an operation are not in
+            // the dump: they keep EOPNOTSUPP
+            //
+            try
+            {
+                dump_rings(ret);
+                dump_coalesce(ret);
+                dump_channels(ret);
+                return ret;
+            }
+            catch(std::system_error &)
+            {
+                ret.clear();
+            }
+        }
+
+        ioctl_tuning(ifnames, ret);
+        return ret;
+    }
+
+} // namespace ethtool
+} // namespace ifshow
+
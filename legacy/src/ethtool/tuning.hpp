@@ -0,0 +1,51 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#pragma once
+
+#include <linux/ethtool.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <ifname.hpp>
+#include <result.hpp>
+
+namespace ifshow { namespace ethtool {
+
+    // the NIC tuning knobs of an interface: ring sizes, interrupt
+    // coalescing and channel counts (each one may be unsupported)
+    //
+    struct tuning
+    {
+        result<ethtool_ringparam>   rings    = fail(EOPNOTSUPP);
+        result<ethtool_coalesce>    coalesce = fail(EOPNOTSUPP);
+        result<ethtool_channels>    channels = fail(EOPNOTSUPP);
+    };
+
+    // the tuning of the given interfaces: three netlink dumps for all of
+    // them (RINGS_GET, COALESCE_GET, CHANNELS_GET), or the ioctls run in
+    // parallel over the interfaces when the kernel has no ethtool netlink
+    //
+    extern std::unordered_map<ifname, tuning>
+    get_tuning(const std::vector<ifname> &ifnames);
+
+} // namespace ethtool
+} // namespace ifshow
+
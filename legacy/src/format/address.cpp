@@ -0,0 +1,233 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <cstring>
+
+#include <format/address.hpp>
+
+namespace ifshow { namespace format {
+
+    namespace
+    {
+        // the 256 bytes in lowercase hex: two digits, and where the
+        // significant ones start
+        //
+        struct hex_table
+        {
+            char pair[256][2];
+
+            constexpr hex_table()
+            : pair()
+            {
+                const char digits[] = "0123456789abcdef";
+                for(int i = 0; i < 256; i++) {
+                    pair[i][0] = digits[i >> 4];
+                    pair[i][1] = digits[i & 15];
+                }
+            }
+        };
+
+        constexpr hex_table hex {};
+
+        inline char *
+        put_hex_byte(char *p, uint8_t b)
+        {
+            if (b >= 16)
+                *p++ = hex.pair[b][0];
+            *p++ = hex.pair[b][1];
+            return p;
+        }
+
+        // a 16-bit group without leading zeros
+        //
+        inline char *
+        put_hex_group(char *p, uint16_t g)
+        {
+            uint8_t hi = static_cast<uint8_t>(g >> 8), lo = static_cast<uint8_t>(g);
+            if (hi) {
+                p = put_hex_byte(p, hi);
+                *p++ = hex.pair[lo][0];
+                *p++ = hex.pair[lo][1];
+                return p;
+            }
+            return put_hex_byte(p, lo);
+        }
+
+        inline char *
+        put_dec_byte(char *p, uint8_t b)
+        {
+            if (b >= 100) {
+                *p++ = static_cast<char>('0' + b / 100);
+                *p++ = static_cast<char>('0' + b / 10 % 10);
+            }
+            else if (b >= 10)
+                *p++ = static_cast<char>('0' + b / 10);
+            *p++ = static_cast<char>('0' + b % 10);
+            return p;
+        }
+
+        inline char *
+        put_dotted(char *p, const uint8_t *b)
+        {
+            p = put_dec_byte(p, b[0]); *p++ = '.';
+            p = put_dec_byte(p, b[1]); *p++ = '.';
+            p = put_dec_byte(p, b[2]); *p++ = '.';
+            return put_dec_byte(p, b[3]);
+        }
+
+        inline int
+        hex_value(char c)
+        {
+            if (c >= '0' && c <= '9')
+                return c - '0';
+            if (c >= 'a' && c <= 'f')
+                return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F')
+                return c - 'A' + 10;
+            return -1;
+        }
+    }
+
+
+    size_t
+    inet(char *buf, const in_addr &addr)
+    {
+        char *p = put_dotted(buf, reinterpret_cast<const uint8_t *>(&addr.s_addr));
+        *p = '\0';
+        return static_cast<size_t>(p - buf);
+    }
+
+
+    size_t
+    inet6(char *buf, const in6_addr &addr)
+    {
+        const uint8_t *b = addr.s6_addr;
+
+        uint16_t group[8];
+        for(int i = 0; i < 8; i++)
+            group[i] = static_cast<uint16_t>(b[2 * i] << 8 | b[2 * i + 1]);
+
+        // the longest run of zero groups (the first one on ties); a single
+        // zero group is not compressed
+        //
+        int best = -1, best_len = 0;
+        for(int i = 0; i < 8; )
+        {
+            if (group[i]) {
+                i++;
+                continue;
+            }
+            int j = i;
+            while (j < 8 && group[j] == 0)
+                j++;
+            if (j - i > best_len) {
+                best = i;
+                best_len = j - i;
+            }
+            i = j;
+        }
+        if (best_len < 2)
+            best = -1;
+
+        char *p = buf;
+
+        for(int i = 0; i < 8; i++)
+        {
+            if (i == best) {
+                *p++ = ':';
+                if (i + best_len == 8)
+                    *p++ = ':';
+                i += best_len - 1;
+                continue;
+            }
+
+            if (i)
+                *p++ = ':';
+
+            // ::a.b.c.d and ::ffff:a.b.c.d
+            //
+            if (i == 6 && best == 0 && (best_len == 6 || (best_len == 5 && group[5] == 0xffff))) {
+                p = put_dotted(p, b + 12);
+                break;
+            }
+
+            p = put_hex_group(p, group[i]);
+        }
+
+        *p = '\0';
+        return static_cast<size_t>(p - buf);
+    }
+
+
+    size_t
+    mac(char *buf, const uint8_t *addr)
+    {
+        char *p = buf;
+        for(int i = 0; i < 6; i++)
+        {
+            if (i)
+                *p++ = ':';
+            p = put_hex_byte(p, addr[i]);
+        }
+        *p = '\0';
+        return static_cast<size_t>(p - buf);
+    }
+
+
+    int
+    prefix_len(const in_addr &mask)
+    {
+        uint32_t m = ntohl(mask.s_addr);
+        return m == UINT32_MAX ? 32 : __builtin_clz(~m);
+    }
+
+
+    int
+    prefix_len(const in6_addr &mask)
+    {
+        uint64_t w[2];
+        std::memcpy(w, mask.s6_addr, sizeof(w));
+
+        uint64_t hi = __builtin_bswap64(w[0]), lo = __builtin_bswap64(w[1]);
+        if (hi != UINT64_MAX)
+            return __builtin_clzll(~hi);
+        return lo == UINT64_MAX ? 128 : 64 + __builtin_clzll(~lo);
+    }
+
+
+    bool
+    parse_inet6_hex(std::string_view hex, in6_addr &addr)
+    {
+        if (hex.size() != 32)
+            return false;
+
+        for(size_t i = 0; i < 16; i++)
+        {
+            int h = hex_value(hex[2 * i]), l = hex_value(hex[2 * i + 1]);
+            if (h < 0 || l < 0)
+                return false;
+            addr.s6_addr[i] = static_cast<uint8_t>(h << 4 | l);
+        }
+
+        return true;
+    }
+
+} // namespace format
+} // namespace ifshow
+
@@ -0,0 +1,65 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <netinet/in.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace ifshow { namespace format {
+
+    // the buffer sizes, NUL included
+    //
+    static const size_t INET_LEN  = 16;     // 255.255.255.255
+    static const size_t INET6_LEN = 46;     // INET6_ADDRSTRLEN
+    static const size_t MAC_LEN   = 18;     // 00:11:22:33:44:55
+
+    /*
+     * Render an address into a caller-provided buffer (no locale, no
+     * allocation) and return its length; the string is NUL-terminated.
+     *
+     * inet6() follows RFC 5952 (lowercase, the longest run of zero groups
+     * compressed) and prints the IPv4-mapped and -compatible addresses in
+     * dotted form, as inet_ntop(3) does. mac() prints the bytes without
+     * leading zeros, as ether_ntoa(3) does, so that the output (and the
+     * snapshot files) don't change.
+     */
+
+    extern size_t inet(char *buf, const in_addr &addr);
+
+    extern size_t inet6(char *buf, const in6_addr &addr);
+
+    extern size_t mac(char *buf, const uint8_t *addr);
+
+    // the number of leading ones of a netmask
+    //
+    extern int prefix_len(const in_addr &mask);
+
+    extern int prefix_len(const in6_addr &mask);
+
+    // 32 hex digits (the address in /proc/net/if_inet6), false if malformed
+    //
+    extern bool parse_inet6_hex(std::string_view hex, in6_addr &addr);
+
+} // namespace format
+} // namespace ifshow
+
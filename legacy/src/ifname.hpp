@@ -0,0 +1,163 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#pragma once
+
+#include <net/if.h>
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace ifshow {
+
+    /*
+     * An interface name stored inline in IFNAMSIZ (16) bytes, NUL padded:
+     * copies don't allocate, equality is two 64-bit compares and the hash
+     * mixes the same two words. Names longer than IFNAMSIZ-1 can't exist
+     * and are rejected with std::length_error.
+     */
+
+    class alignas(16) ifname
+    {
+    public:
+        ifname()
+        : m_data()
+        {}
+
+        ifname(std::string_view name)
+        : m_data()
+        {
+            if (name.size() >= IFNAMSIZ)
+                throw std::length_error("interface name too long: " + std::string(name));
+            memcpy(m_data, name.data(), name.size());
+        }
+
+        ifname(const char *name)
+        : ifname(std::string_view(name))
+        {}
+
+        ifname(const std::string &name)
+        : ifname(std::string_view(name))
+        {}
+
+        // always NUL terminated
+        //
+        const char *
+        c_str() const
+        {
+            return m_data;
+        }
+
+        size_t
+        size() const
+        {
+            return strnlen(m_data, IFNAMSIZ);
+        }
+
+        bool
+        empty() const
+        {
+            return m_data[0] == '\0';
+        }
+
+        std::string_view
+        view() const
+        {
+            return std::string_view(m_data, size());
+        }
+
+        std::string
+        str() const
+        {
+            return std::string(m_data, size());
+        }
+
+        // for the functions that build sysfs/procfs paths
+        //
+        operator std::string() const
+        {
+            return str();
+        }
+
+        uint64_t
+        word(int n) const
+        {
+            uint64_t w;
+            memcpy(&w, m_data + n * 8, 8);
+            return w;
+        }
+
+        friend bool
+        operator==(const ifname &a, const ifname &b)
+        {
+            return ((a.word(0) ^ b.word(0)) | (a.word(1) ^ b.word(1))) == 0;
+        }
+
+        friend bool
+        operator!=(const ifname &a, const ifname &b)
+        {
+            return !(a == b);
+        }
+
+        // the order of strcmp: the NUL padding sorts first, and the words
+        // compare as big-endian numbers
+        //
+        friend bool
+        operator<(const ifname &a, const ifname &b)
+        {
+            uint64_t a0 = __builtin_bswap64(a.word(0)), b0 = __builtin_bswap64(b.word(0));
+            if (a0 != b0)
+                return a0 < b0;
+            return __builtin_bswap64(a.word(1)) < __builtin_bswap64(b.word(1));
+        }
+
+        friend std::ostream &
+        operator<<(std::ostream &out, const ifname &name)
+        {
+            return out << name.c_str();
+        }
+
+    private:
+        char m_data[IFNAMSIZ];
+    };
+
+    static_assert(sizeof(ifname) == 16, "ifname must be 16 bytes");
+
+} // namespace ifshow
+
+
+namespace std
+{
+    template <>
+    struct hash<ifshow::ifname>
+    {
+        size_t
+        operator()(const ifshow::ifname &name) const
+        {
+            uint64_t h = name.word(0) * 0x9e3779b97f4a7c15ULL;
+            h ^= (name.word(1) + (h << 6) + (h >> 2)) * 0xc2b2ae3d27d4eb4fULL;
+            return static_cast<size_t>(h ^ (h >> 29));
+        }
+    };
+}
+
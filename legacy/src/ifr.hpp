@@ -26,15 +26,21 @@
 #include <net/if.h>
 #include <netinet/ether.h>
 #include <arpa/inet.h>
+#include <netdb.h>
 
 #include <linux/ethtool.h>
 #include <linux/version.h>
 #include <linux/sockios.h>
 #include <asm/types.h>
 
+#include <algorithm>
+#include <charconv>
 #include <string>
 #include <cstring>
+#include <fstream>
 #include <sstream>
+#include <tuple>
+#include <vector>
 #include <stdexcept>
 #include <cerrno>
 #include <memory>
@@ -42,9 +48,15 @@
 
 #include <string-utils.hpp>
 #include <iomanip.hpp>
+#include <lexical_cast.hpp>
 
+#include <format/address.hpp>
+#include <proc/file.hpp>
 #include <proc/files.hpp>
 
+#include <ifname.hpp>
+#include <result.hpp>
+
 #include <macro.h>
 #include <iwlib.h>
 #include <ifaddrs.h>
@@ -54,25 +66,42 @@ namespace ifshow {
     class ifr
     {
     public:
-        ifr(std::string name)
-        : m_name(std::move(name))
+        ifr(const ifname &name)
+        : m_name(name)
         , m_ifreq_io()
         {
-            strncpy(m_ifreq_io.ifr_name, m_name.c_str(), IFNAMSIZ);
+            memcpy(m_ifreq_io.ifr_name, m_name.c_str(), IFNAMSIZ);
         }
 
         ~ifr()
         {}
 
-        short int
-        flags() const
+        const ifname &
+        name() const
+        {
+            return m_name;
+        }
+
+        /*
+         * the try_ getters return a result<T> (value or errno) and never
+         * throw on ioctl failure; the plain getters throw std::system_error
+         */
+
+        result<short int>
+        try_flags() const
         {
             if (ioctl(ifr::sock_(), SIOCGIFFLAGS, &m_ifreq_io) < 0)
-                throw std::system_error(errno, std::generic_category());
+                return fail(errno);
 
             return m_ifreq_io.ifr_flags;
         }
 
+        short int
+        flags() const
+        {
+            return try_flags().value();
+        }
+
         std::string
         flags_str() const
         {
@@ -112,60 +141,254 @@ namespace ifshow {
          * the function return an ethtool_drvinfo structure
          */
 
+        result<ethtool_drvinfo>
+        try_ethtool_info() const
+        {
+            ethtool_drvinfo drvinfo;
+            memset(&drvinfo, 0, sizeof(drvinfo));
+
+            drvinfo.cmd = ETHTOOL_GDRVINFO;	/* netdev ethcmd */
+
+            m_ifreq_io.ifr_data = reinterpret_cast<__caddr_t>(&drvinfo);
+            if (ioctl(sock_(), SIOCETHTOOL, &m_ifreq_io) == -1) {
+                return fail(errno);
+            }
+
+            return drvinfo;
+        }
+
         std::unique_ptr<ethtool_drvinfo>
         ethtool_info() const
         {
-            std::unique_ptr<ethtool_drvinfo> drvinfo(new ethtool_drvinfo);
+            return std::unique_ptr<ethtool_drvinfo>(new ethtool_drvinfo(try_ethtool_info().value()));
+        }
 
-            uint32_t req = ETHTOOL_GDRVINFO;	/* netdev ethcmd */
+        result<ethtool_cmd>
+        try_ethtool_command() const
+        {
+            ethtool_cmd ecmd;
+            memset(&ecmd, 0, sizeof(ecmd));
 
-            m_ifreq_io.ifr_data = reinterpret_cast<__caddr_t>(drvinfo.get());
-            memcpy(m_ifreq_io.ifr_data, (char *) &req, sizeof(req));
+            ecmd.cmd = ETHTOOL_GSET;
+            m_ifreq_io.ifr_data = reinterpret_cast<__caddr_t>(&ecmd);
 
             if (ioctl(sock_(), SIOCETHTOOL, &m_ifreq_io) == -1) {
-                throw std::system_error(errno, std::generic_category());
+                return fail(errno);
             }
 
-            return drvinfo;
+            return ecmd;
         }
 
         std::unique_ptr<ethtool_cmd>
         ethtool_command() const
         {
-            std::unique_ptr<ethtool_cmd> ecmd(new ethtool_cmd);
+            return std::unique_ptr<ethtool_cmd>(new ethtool_cmd(try_ethtool_command().value()));
+        }
 
-            ecmd->cmd = ETHTOOL_GSET;
-            m_ifreq_io.ifr_data = reinterpret_cast<__caddr_t>(ecmd.get());
+        result<bool>
+        try_ethtool_link() const
+        {
+            struct ethtool_value edata;
+            edata.cmd = ETHTOOL_GLINK;
 
+            m_ifreq_io.ifr_data = reinterpret_cast<__caddr_t>(&edata);
             if (ioctl(sock_(), SIOCETHTOOL, &m_ifreq_io) == -1) {
-                throw std::system_error(errno, std::generic_category());
+                return fail(errno);
             }
 
-            return ecmd;
+            return edata.data != 0;
         }
 
         bool
         ethtool_link() const
         {
-            struct ethtool_value edata;
-            edata.cmd = ETHTOOL_GLINK;
+            return try_ethtool_link().value();
+        }
 
-            m_ifreq_io.ifr_data = reinterpret_cast<__caddr_t>(&edata);
+        /*
+         * ring sizes, interrupt coalescing and channel counts
+         */
+
+        result<ethtool_ringparam>
+        try_ringparam() const
+        {
+            ethtool_ringparam ring;
+            memset(&ring, 0, sizeof(ring));
+            ring.cmd = ETHTOOL_GRINGPARAM;
+
+            m_ifreq_io.ifr_data = reinterpret_cast<__caddr_t>(&ring);
+            if (ioctl(sock_(), SIOCETHTOOL, &m_ifreq_io) == -1) {
+                return fail(errno);
+            }
+
+            return ring;
+        }
+
+        result<ethtool_coalesce>
+        try_coalesce() const
+        {
+            ethtool_coalesce coal;
+            memset(&coal, 0, sizeof(coal));
+            coal.cmd = ETHTOOL_GCOALESCE;
+
+            m_ifreq_io.ifr_data = reinterpret_cast<__caddr_t>(&coal);
+            if (ioctl(sock_(), SIOCETHTOOL, &m_ifreq_io) == -1) {
+                return fail(errno);
+            }
+
+            return coal;
+        }
+
+        result<ethtool_channels>
+        try_channels() const
+        {
+            ethtool_channels chan;
+            memset(&chan, 0, sizeof(chan));
+            chan.cmd = ETHTOOL_GCHANNELS;
+
+            m_ifreq_io.ifr_data = reinterpret_cast<__caddr_t>(&chan);
+            if (ioctl(sock_(), SIOCETHTOOL, &m_ifreq_io) == -1) {
+                return fail(errno);
+            }
+
+            return chan;
+        }
+
+        /*
+         * number of strings in the given string set (ETHTOOL_GSSET_INFO)
+         */
+
+        result<uint32_t>
+        try_ethtool_sset_count(ethtool_stringset set) const
+        {
+            alignas(ethtool_sset_info) char buf[sizeof(ethtool_sset_info) + sizeof(uint32_t)] = {};
+            auto sset = reinterpret_cast<ethtool_sset_info *>(buf);
+
+            sset->cmd = ETHTOOL_GSSET_INFO;
+            sset->sset_mask = 1ULL << set;
+
+            m_ifreq_io.ifr_data = reinterpret_cast<__caddr_t>(sset);
+            if (ioctl(sock_(), SIOCETHTOOL, &m_ifreq_io) == -1) {
+                return fail(errno);
+            }
+
+            return sset->sset_mask ? sset->data[0] : 0;
+        }
+
+        uint32_t
+        ethtool_sset_count(ethtool_stringset set) const
+        {
+            return try_ethtool_sset_count(set).value();
+        }
+
+        std::vector<std::string>
+        ethtool_strings(ethtool_stringset set, uint32_t n) const
+        {
+            std::vector<char> buf(sizeof(ethtool_gstrings) + n * ETH_GSTRING_LEN);
+            auto strs = reinterpret_cast<ethtool_gstrings *>(buf.data());
+
+            strs->cmd = ETHTOOL_GSTRINGS;
+            strs->string_set = set;
+            strs->len = n;
+
+            m_ifreq_io.ifr_data = reinterpret_cast<__caddr_t>(strs);
             if (ioctl(sock_(), SIOCETHTOOL, &m_ifreq_io) == -1) {
                 throw std::system_error(errno, std::generic_category());
             }
 
-            return edata.data;
+            std::vector<std::string> ret;
+            ret.reserve(strs->len);
+
+            for(uint32_t i = 0; i < std::min(n, strs->len); i++)
+            {
+                auto s = reinterpret_cast<const char *>(strs->data + i * ETH_GSTRING_LEN);
+                ret.emplace_back(s, strnlen(s, ETH_GSTRING_LEN));
+            }
+
+            return ret;
         }
 
-        std::string
-        mac() const
+        /*
+         * the n blocks of 32 features (ETHTOOL_GFEATURES)
+         */
+
+        result<std::vector<ethtool_get_features_block>>
+        try_features(uint32_t n) const
+        {
+            std::vector<char> buf(sizeof(ethtool_gfeatures) + n * sizeof(ethtool_get_features_block));
+            auto feat = reinterpret_cast<ethtool_gfeatures *>(buf.data());
+
+            feat->cmd = ETHTOOL_GFEATURES;
+            feat->size = n;
+
+            m_ifreq_io.ifr_data = reinterpret_cast<__caddr_t>(feat);
+            if (ioctl(sock_(), SIOCETHTOOL, &m_ifreq_io) == -1) {
+                return fail(errno);
+            }
+
+            return std::vector<ethtool_get_features_block>(feat->features, feat->features + std::min(n, feat->size));
+        }
+
+        /*
+         * read the n driver statistics (ETHTOOL_GSTATS) into out[0..n)
+         */
+
+        result<bool>
+        try_ethtool_stats(uint64_t *out, uint32_t n) const
+        {
+            thread_local std::vector<uint64_t> buf;
+
+            // the kernel ignores n_stats and writes as many statistics as
+            // the driver has now: if they changed (e.g. channels were
+            // reconfigured) the caller must rebuild its layout
+            //
+            auto count = try_ethtool_sset_count(ETH_SS_STATS);
+            if (!count)
+                return fail(count.error());
+            if (*count != n)
+                return fail(EAGAIN);
+
+            // the ethtool_stats header takes exactly one u64
+            //
+            buf.resize(*count + 1);
+
+            auto stats = reinterpret_cast<struct ethtool_stats *>(buf.data());
+            stats->cmd = ETHTOOL_GSTATS;
+            stats->n_stats = *count;
+
+            m_ifreq_io.ifr_data = reinterpret_cast<__caddr_t>(stats);
+            if (ioctl(sock_(), SIOCETHTOOL, &m_ifreq_io) == -1) {
+                return fail(errno);
+            }
+
+            if (stats->n_stats != n)
+                return fail(EAGAIN);
+
+            memcpy(out, stats->data, n * sizeof(uint64_t));
+            return true;
+        }
+
+        void
+        ethtool_stats(uint64_t *out, uint32_t n) const
+        {
+            try_ethtool_stats(out, n).value();
+        }
+
+        result<std::string>
+        try_mac() const
         {
             if (ioctl(sock_(), SIOCGIFHWADDR, &m_ifreq_io) == -1) {
-                throw std::system_error(errno, std::generic_category());
+                return fail(errno);
             }
-            struct ether_addr *eth_addr = (struct ether_addr *) & m_ifreq_io.ifr_addr.sa_data;
-            return  ether_ntoa(eth_addr);
+            char buf[format::MAC_LEN];
+            size_t len = format::mac(buf, reinterpret_cast<const uint8_t *>(m_ifreq_io.ifr_hwaddr.sa_data));
+            return std::string(buf, len);
+        }
+
+        std::string
+        mac() const
+        {
+            return try_mac().value();
         }
 
         int
@@ -202,33 +425,21 @@ namespace ifshow {
 
             // loop through the list of interfaces
             for (ifa = ifaddr; ifa != NULL; ifa = ifa->ifa_next) {
-                if (strcmp(ifa->ifa_name, m_name.c_str()) != 0) {
+                if (ifname(ifa->ifa_name) != m_name) {
                     continue;
                 }
 
-                if (ifa->ifa_addr->sa_family == AF_INET) 
+                if (ifa->ifa_addr && ifa->ifa_addr->sa_family == AF_INET) 
                 {
-                    char host[NI_MAXHOST], netmask[NI_MAXHOST];
-
-                    if (getnameinfo(ifa->ifa_addr, sizeof(struct sockaddr_in), host, NI_MAXHOST, NULL, 0, NI_NUMERICHOST) != 0) {
-                        throw std::system_error(errno, std::generic_category());
-                    }
-
-                    if (getnameinfo(ifa->ifa_netmask, sizeof(struct sockaddr_in), netmask, NI_MAXHOST, NULL, 0, NI_NUMERICHOST) != 0) {
-                        throw std::system_error(errno, std::generic_category());
-                    }
+                    auto &addr = reinterpret_cast<sockaddr_in *>(ifa->ifa_addr)->sin_addr;
+                    auto &mask = reinterpret_cast<sockaddr_in *>(ifa->ifa_netmask)->sin_addr;
 
-                    // convert the mask to binary
-                    uint32_t mask_bin = ntohl(reinterpret_cast<sockaddr_in*>(ifa->ifa_netmask)->sin_addr.s_addr);
-                    // count the number of consecutive 1's from the leftmost bit position
-                    int prefix_len = 0;
+                    char host[format::INET_LEN], netmask[format::INET_LEN];
 
-                    while (mask_bin) {
-                        prefix_len++;
-                        mask_bin <<= 1;
-                    }
+                    size_t hlen = format::inet(host, addr);
+                    size_t mlen = format::inet(netmask, mask);
 
-                    ret.emplace_back(host, netmask, prefix_len);
+                    ret.emplace_back(std::string(host, hlen), std::string(netmask, mlen), format::prefix_len(mask));
                 }
             }
             freeifaddrs(ifaddr);
@@ -240,79 +451,89 @@ namespace ifshow {
         {
             std::vector<std::tuple<std::string, int, std::string>> ret;
 
-            char addr6p[8][5], devname[20], addr6[40];
-            struct in6_addr in_addr6;
-            int plen, scope, dad_status, if_idx;
-
-            FILE *f;
-
-            if ( (f=fopen(proc::IFINET6,"r")) == NULL) {
+            auto buf = proc::try_read_file(proc::IFINET6);
+            if (!buf)
                 return {};
-            }
 
-            while (fscanf(f, "%4s%4s%4s%4s%4s%4s%4s%4s %02x %02x %02x %02x %20s\n",
-                          addr6p[0], addr6p[1], addr6p[2], addr6p[3],
-                          addr6p[4], addr6p[5], addr6p[6], addr6p[7],
-                          &if_idx, &plen, &scope, &dad_status, devname) != EOF)
+            // "fe80000000000000021122fffe334455 02 40 20 80     eth0": the
+            // address, ifindex, prefix length, scope and flags in hex
+            //
+            for(auto line : more::tokens(*buf, "\n"))
             {
-                std::ostringstream ss;
-
-                if ( strcmp(m_name.c_str(),devname) )
+                std::string_view field[6];
+                size_t n = 0;
+                for(auto f : more::tokens(line, " "))
+                    if (!f.empty() && n < 6)
+                        field[n++] = f;
+
+                in6_addr addr;
+                if (n < 6 || ifname(field[5]) != m_name || !format::parse_inet6_hex(field[0], addr))
                     continue;
 
-                sprintf(addr6, "%s:%s:%s:%s:%s:%s:%s:%s",
-                        addr6p[0], addr6p[1], addr6p[2], addr6p[3],
-                        addr6p[4], addr6p[5], addr6p[6], addr6p[7]);
-
-                /* pretty host */
-                inet_pton(PF_INET6,addr6,&in_addr6);
-                inet_ntop(PF_INET6,&in_addr6, addr6, 40);
+                int plen = 0, scope = 0;
+                std::from_chars(field[2].data(), field[2].data() + field[2].size(), plen, 16);
+                std::from_chars(field[3].data(), field[3].data() + field[3].size(), scope, 16);
 
+                const char *attr;
                 switch (scope) {
                 case 0:
-                    ss << "global";
+                    attr = "global";
                     break;
                 case IPV6_ADDR_LINKLOCAL:
-                    ss << "link";
+                    attr = "link";
                     break;
                 case IPV6_ADDR_SITELOCAL:
-                    ss << "site";
+                    attr = "site";
                     break;
                 case IPV6_ADDR_COMPATv4:
-                    ss << "compat";
+                    attr = "compat";
                     break;
                 case IPV6_ADDR_LOOPBACK:
-                    ss << "host";
+                    attr = "host";
                     break;
                 default:
-                    ss << "unknown";
+                    attr = "unknown";
                 }
-                
-                ret.emplace_back(addr6, plen, ss.str());
+
+                char addr6[format::INET6_LEN];
+                size_t len = format::inet6(addr6, addr);
+
+                ret.emplace_back(std::string(addr6, len), plen, attr);
             }
 
-            fclose(f);
             return ret;
         }
 
-        struct ifmap
-        map() const
+        result<struct ifmap>
+        try_map() const
         {
             if (ioctl(sock_(), SIOCGIFMAP, &m_ifreq_io) == -1 ) {
-                throw std::system_error(errno, std::generic_category());
+                return fail(errno);
             }
             return m_ifreq_io.ifr_ifru.ifru_map;
         }
 
-        int
-        txqueuelen() const
+        struct ifmap
+        map() const
+        {
+            return try_map().value();
+        }
+
+        result<int>
+        try_txqueuelen() const
         {
             if (ioctl(sock_(), SIOCGIFTXQLEN, &m_ifreq_io) == -1 ) {
-                throw std::system_error(errno, std::generic_category());
+                return fail(errno);
             }
             return m_ifreq_io.ifr_qlen;
         }
 
+        int
+        txqueuelen() const
+        {
+            return try_txqueuelen().value();
+        }
+
         struct stats {
             unsigned int    rx_bytes;
             unsigned int    rx_packets;
@@ -332,31 +553,42 @@ namespace ifshow {
         stats
         get_stats() const
         {
-            std::ifstream proc_net_dev(proc::NET_DEV);
+            auto buf = proc::read_file(proc::NET_DEV);
 
-            std::string line;
+            more::tokenizer lines(buf, "\n");
+            std::string_view line;
 
             /* skip 2 lines */
-            getline(proc_net_dev,line);
-            getline(proc_net_dev,line);
-
-            stats ret;
-            while (getline(proc_net_dev,line)) {
-                std::istringstream ss(line);
-                more::string_token if_name(":");
-                ss >> if_name;
-
-                std::string name = more::trim_copy(static_cast<std::string>(if_name));
+            lines.next(line);
+            lines.next(line);
 
-                if ( name != m_name)
+            while (lines.next(line)) {
+                auto colon = line.find(':');
+                if (colon == std::string_view::npos)
                     continue;
 
-                int compressed, multicast;
+                if (ifname(more::trim_view(line.substr(0, colon))) != m_name)
+                    continue;
 
-                ss >> ret.rx_bytes >> ret.rx_packets >> ret.rx_errs >> ret.rx_drop >> ret.rx_fifo >> ret.rx_frame
-                   >> compressed >> multicast;
+                // rx: bytes packets errs drop fifo frame compressed multicast
+                // tx: bytes packets errs drop fifo colls carrier compressed
+                //
+                unsigned int v[14] = { 0 };
+                size_t n = 0;
+                for(auto f : more::tokens(line.substr(colon + 1), " "))
+                {
+                    if (f.empty())
+                        continue;
+                    if (n == 14)
+                        break;
+                    v[n++] = static_cast<unsigned int>(more::try_lexical_cast<unsigned long long>(f).value_or(0));
+                }
 
-                ss >> ret.tx_bytes >> ret.tx_packets >> ret.tx_errs >> ret.tx_drop >> ret.tx_fifo >> ret.tx_colls;
+                stats ret;
+                ret.rx_bytes   = v[0];  ret.rx_packets = v[1];  ret.rx_errs = v[2];
+                ret.rx_drop    = v[3];  ret.rx_fifo    = v[4];  ret.rx_frame = v[5];
+                ret.tx_bytes   = v[8];  ret.tx_packets = v[9];  ret.tx_errs = v[10];
+                ret.tx_drop    = v[11]; ret.tx_fifo    = v[12]; ret.tx_colls = v[13];
                 return ret;
             }
 
@@ -364,14 +596,14 @@ namespace ifshow {
         }
 
 
-        wireless_info
-        wifi_info() const
+        result<wireless_info>
+        try_wifi_info() const
         {
             wireless_info info;
             memset(&info, 0, sizeof(wireless_info));
 
             if (iw_get_basic_config(sock_(), m_name.c_str(), &info.b) < 0)
-                throw std::runtime_error("no wireless extension");
+                return fail(errno ? errno : EOPNOTSUPP);
 
             struct iwreq wrq;
             if (iw_get_ext(sock_(), m_name.c_str(), SIOCGIWAP, &wrq) >= 0) {
@@ -388,6 +620,15 @@ namespace ifshow {
             return info;
         }
 
+        wireless_info
+        wifi_info() const
+        {
+            auto info = try_wifi_info();
+            if (!info)
+                throw std::runtime_error("no wireless extension");
+            return *info;
+        }
+
     private:
         static int
         sock_()
@@ -398,7 +639,7 @@ namespace ifshow {
             return sock;
         }
 
-        std::string m_name;
+        ifname m_name;
 
         mutable struct ifreq m_ifreq_io;
 
@@ -22,6 +22,8 @@
 #include <sstream>
 #include <string>
 #include <list>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <algorithm>
@@ -30,7 +32,6 @@
 
 #include <getopt.h>
 
-#include <colorful.hpp>      // more
 #include <iomanip.hpp>       // more
 #include <string-utils.hpp>  // more
 
@@ -38,6 +39,18 @@
 #include <proc/interrupt.hpp>
 #include <proc/net_dev.hpp>
 
+#include <ethtool/features.hpp>
+#include <ethtool/stats.hpp>
+#include <ethtool/tuning.hpp>
+#include <watch/watch.hpp>
+#include <probe/caps.hpp>
+#include <probe/kind.hpp>
+#include <shm/ring.hpp>
+#include <snapshot/snapshot.hpp>
+
+#include <options.hpp>
+#include <colors.hpp>
+
 #include <ifr.hpp>
 #include <net/if.h>
 
@@ -51,26 +64,6 @@ static const char * version = "2.0";
 using namespace ifshow;
 
 
-struct options
-{
-    std::vector<std::string>    if_list;
-    std::vector<std::string>    driver;
-    bool                        verbose;
-    bool                        all;
-};
-
-
-typedef more::colorful< more::ecma::bold >          bold;
-typedef more::colorful< more::ecma::reset >         reset;
-typedef more::colorful< more::ecma::fg::red >       red;
-typedef more::colorful< more::ecma::fg::blue>       blue;
-typedef more::colorful< more::ecma::fg::yellow>     yellow; 
-typedef more::colorful< more::ecma::fg::green>      green; 
-typedef more::colorful< more::ecma::fg::cyan>       cyan; 
-typedef more::colorful< more::ecma::fg::magenta>    magenta; 
-typedef more::colorful< more::ecma::fg::light_grey> grey; 
-
-
 template <typename CharT, typename Traits, typename Fun>
 void pretty_print(std::basic_ostream<CharT, Traits> &out, size_t sp, Fun fun)
 {
@@ -98,12 +91,12 @@ show_interfaces(const options &opts)
 {
     auto ifs = proc::get_if_list();
 
-    auto longest = std::max_element(ifs.begin(), ifs.end(), [](const std::string &lhs, const std::string &rhs) {
-                                        return lhs.length() < rhs.length();
+    auto longest = std::max_element(ifs.begin(), ifs.end(), [](const ifname &lhs, const ifname &rhs) {
+                                        return lhs.size() < rhs.size();
                                         }
                                     );
 
-    size_t indent = longest->length() + 2;
+    size_t indent = longest->size() + 2;
 
     struct pci_access *pacc = pci_alloc();
 
@@ -123,9 +116,61 @@ show_interfaces(const options &opts)
     //
     char pci_namebuf[1024], pci_classbuf[128];
 
+    // wireless interfaces...
+    //
+    auto wireless = proc::get_wireless();
+
+    // the probes known to fail, per driver...
+    //
+    auto &caps = probe::capabilities();
+    auto cache = opts.cache ? probe::cache_path() : std::string();
+    if (!cache.empty())
+        caps.load(cache);
+
+    // classify the interfaces, to run only the probes that can succeed...
+    //
+    std::map<ifname, probe::interface> kinds;
+    try
+    {
+        kinds = probe::classify();
+    }
+    catch(std::exception &)
+    {
+    }
+
+    // rings, coalescing and channels of all the interfaces at once...
+    //
+    std::unordered_map<ifname, ethtool::tuning> tuning;
+    if (opts.verbose)
+    {
+        try
+        {
+            tuning = ethtool::get_tuning(opts.if_list.empty() ? ifs : opts.if_list);
+        }
+        catch(std::exception &)
+        {
+        }
+    }
+
+    // ...and their offload features
+    //
+    std::unordered_map<ifname, ethtool::feature_set> features;
+    if (opts.verbose || !opts.feature_missing.empty())
+    {
+        try
+        {
+            features = ethtool::get_features(opts.if_list.empty() ? ifs : opts.if_list);
+        }
+        catch(std::exception &)
+        {
+        }
+    }
+
     int devnum = 0;
 
-    for(auto & name : proc::get_if_list())
+    std::unordered_set<ifname> list(opts.if_list.begin(), opts.if_list.end());
+
+    for(auto & name : ifs)
     {
         try
         {
@@ -135,29 +180,29 @@ show_interfaces(const options &opts)
 
             // in case the list is given, skip the interface if not included
             //
-            if (!opts.if_list.empty() &&
-                find(opts.if_list.begin(), opts.if_list.end(), name) == opts.if_list.end())
+            if (!list.empty() && !list.count(name))
                 continue;
 
             std::cout << reset();
 
             // display the interface when it's UP or -a is passed at command line
             //
-            if (!opts.all && (iif.flags() & IFF_UP) == 0 && find(opts.if_list.begin(), opts.if_list.end(), name) == opts.if_list.end())
-                continue;
+            if (!opts.all && !list.count(name))
+            {
+                auto flags = iif.try_flags();
+                if (!flags || (*flags & IFF_UP) == 0)
+                    continue;
+            }
 
-            // get ether info...
-            //
+            auto ki   = kinds.find(name);
+            auto kind = ki != kinds.end() ? ki->second.kind : probe::unknown;
+            auto plan = probe::get_probe_plan(kind);
+
+            // get ether info (virtual interfaces may have none)...
             //
 
-            std::unique_ptr<ethtool_drvinfo> info;
-            try
-            {
-                info = iif.ethtool_info();
-            }
-            catch(...)
-            {
-            }
+            auto info = plan.drvinfo ? iif.try_ethtool_info() : result<ethtool_drvinfo>(fail(EOPNOTSUPP));
+            auto key  = info ? probe::driver_key(*info) : std::string();
 
             // driver filter...
             //
@@ -171,6 +216,20 @@ show_interfaces(const options &opts)
                     continue;
             }
 
+            // feature filter: at least one of the features is not active...
+            //
+
+            auto fi = features.find(name);
+
+            if (!opts.feature_missing.empty())
+            {
+                if (fi == features.end() || std::all_of(std::begin(opts.feature_missing), std::end(opts.feature_missing), [&](const std::string &feat) -> bool
+                                         {
+                                            return ethtool::feature_set::test(fi->second.active, ethtool::feature_index(feat));
+                                         }))
+                    continue;
+            }
+
             if (devnum++) {
                 std::cout << std::endl;
             }
@@ -181,17 +240,25 @@ show_interfaces(const options &opts)
                 //
                 std::cout << std::left << cyan() << std::setw(indent-1) << name << reset() << ' ' << std::flush;
 
-                auto ecmd = iif.ethtool_command();
-                if (iif.ethtool_link())
-                std::cout << bold();
+                if (!plan.link_settings)
+                    return;
+
+                auto ecmd = caps.attempt(key, probe::ethtool_gset, [&] { return iif.try_ethtool_command(); });
+                if (!ecmd) {
+                    std::cout << "info: " << ecmd.what() << " ";
+                    return;
+                }
+
+                auto link = caps.attempt(key, probe::ethtool_glink, [&] { return iif.try_ethtool_link(); });
+                if (link && *link)
+                    std::cout << bold();
 
                 // display Link-Speed (if supported)
                 //
-                if (ecmd)
                 {
-                    uint32_t speed = ethtool_cmd_speed(ecmd.get());
+                    uint32_t speed = ethtool_cmd_speed(&*ecmd);
 
-                    std::cout << "link " << (iif.ethtool_link() ? "yes " : "no ");
+                    std::cout << "link " << (link && *link ? "yes " : "no ");
 
                     if (speed != 0 && speed != (uint16_t)(-1) && speed != (uint32_t)(-1))
                         std::cout << "speed " << speed << "Mb/s ";
@@ -237,51 +304,71 @@ show_interfaces(const options &opts)
             {
                 // display HWaddr
                 //
-                std::cout << "link " << yellow() << iif.mac() << reset();
+                auto mac = iif.try_mac();
+                if (!mac) {
+                    std::cout << "info: " << mac.what() << " ";
+                    return;
+                }
+
+                std::cout << "link " << yellow() << *mac << reset();
             });
 
             std::cout << reset();
 
-            // display wireless config if avaiable
+            // display the kind of virtual interfaces (and loopback)
             //
+            if (kind != probe::unknown && kind != probe::physical && kind != probe::wireless)
+            {
+                pretty_printLn(std::cout, indent, [&]
+                {
+                    std::cout << "kind " << probe::kind_details(ki->second, kinds);
+                });
+            }
 
-            pretty_printLn(std::cout, indent, [&]
+            // display wireless config and info, only for the interfaces listed
+            // in /proc/net/wireless (the others have no wireless extensions)
+            //
+            auto wi = wireless.find(name);
+            if (plan.wireless && wi != wireless.end())
             {
-                char buffer[128];
+                pretty_printLn(std::cout, indent, [&]
+                {
+                    char buffer[128];
 
-                wireless_info winfo = iif.wifi_info();
+                    auto wifi = caps.attempt(key, probe::wireless_ext, [&] { return iif.try_wifi_info(); });
+                    if (!wifi) {
+                        std::cout << "info: no wireless extension ";
+                        return;
+                    }
 
-                std::cout << winfo.b.name << " ESSID:" << winfo.b.essid << " mode:" <<
-                             iw_operation_mode[winfo.b.mode] << " frequency:" << winfo.b.freq << std::endl << more::spaces(indent);
+                    wireless_info &winfo = *wifi;
 
-                if (winfo.has_bitrate)
-                {
-                    iw_print_bitrate(buffer,sizeof(buffer), winfo.bitrate.value);
-                    std::cout << "bit-rate:" << buffer << ' ';
-                }
+                    std::cout << winfo.b.name << " ESSID:" << winfo.b.essid << " mode:" <<
+                                 iw_operation_mode[winfo.b.mode] << " frequency:" << winfo.b.freq << std::endl << more::spaces(indent);
 
-                if (winfo.has_ap_addr)
-                {
-                    std::cout << "access point:" << iw_sawap_ntop(&winfo.ap_addr, buffer);
-                }
+                    if (winfo.has_bitrate)
+                    {
+                        iw_print_bitrate(buffer,sizeof(buffer), winfo.bitrate.value);
+                        std::cout << "bit-rate:" << buffer << ' ';
+                    }
 
-            });
+                    if (winfo.has_ap_addr)
+                    {
+                        std::cout << "access point:" << iw_sawap_ntop(&winfo.ap_addr, buffer);
+                    }
 
-            // display wireless info, if available
-            //
-            auto wi = proc::get_wireless(name);
-            if ( std::get<0>(wi) != 0.0 ||
-                 std::get<1>(wi) != 0.0 ||
-                 std::get<2>(wi) != 0.0 ||
-                 std::get<3>(wi) != 0.0 )
-            {
+                });
 
-                pretty_printLn(std::cout, indent, [&]
+                auto const &[status, link, level, noise] = wi->second;
+                if (status != 0.0 || link != 0.0 || level != 0.0 || noise != 0.0)
                 {
-                    std::cout << "wifi status:" << std::get<0>(wi) <<
-                               " link:" << std::get<1>(wi) << " level:" << std::get<2>(wi) <<
-                               " noise:" << std::get<3>(wi);
-                });
+                    pretty_printLn(std::cout, indent, [&]
+                    {
+                        std::cout << "wifi status:" << status <<
+                                   " link:" << link << " level:" << level <<
+                                   " noise:" << noise;
+                    });
+                }
             }
 
             // display flags, mtu and metric
@@ -315,7 +402,13 @@ show_interfaces(const options &opts)
                 {
                     // display map info
                     //
-                    ifmap m = iif.map();
+                    auto map = caps.attempt(key, probe::ifmap, [&] { return iif.try_map(); });
+                    if (!map) {
+                        std::cout << "info: " << map.what() << " ";
+                        return;
+                    }
+
+                    ifmap &m = *map;
 
                     std::cout << "if_index:" << if_nametoindex(name.c_str())
                                << std::hex << " base_addr:0x" << m.base_addr;
@@ -328,10 +421,9 @@ show_interfaces(const options &opts)
                     // display irq events per cpu
                     //
                     auto cpuint = proc::get_interrupt_counter(static_cast<int>(m.irq));
-                    int n = 0;
-                    for(auto ci : cpuint) {
-                        if (ci > 0) {
-                            std::cout << " cpu" << n++ << ":" << ci;
+                    for(size_t n = 0; n < cpuint.size(); n++) {
+                        if (cpuint[n] > 0) {
+                            std::cout << " cpu" << n << ":" << cpuint[n];
                         }
                     }
 
@@ -355,16 +447,144 @@ show_interfaces(const options &opts)
                     std::cout << more::spaces(indent) << "colls:" << s.tx_colls << " txqueuelen:" << iif.txqueuelen();
                 });
 
-                // ... display drvinfo if available
+                // ... display ring sizes, channels (current/max) and coalescing
+                //
+
+                auto ti = tuning.find(name);
+                if (ti != tuning.end())
+                {
+                    auto &t = ti->second;
+
+                    if (t.rings || t.channels)
+                    {
+                        pretty_printLn(std::cout, indent, [&]
+                        {
+                            auto knob = [](const char *what, uint32_t cur, uint32_t max) {
+                                if (cur || max)
+                                    std::cout << ' ' << what << ':' << cur << '/' << max;
+                            };
+
+                            if (t.rings) {
+                                std::cout << "rings";
+                                knob("rx", t.rings->rx_pending, t.rings->rx_max_pending);
+                                knob("rx-mini", t.rings->rx_mini_pending, t.rings->rx_mini_max_pending);
+                                knob("rx-jumbo", t.rings->rx_jumbo_pending, t.rings->rx_jumbo_max_pending);
+                                knob("tx", t.rings->tx_pending, t.rings->tx_max_pending);
+                                std::cout << ' ';
+                            }
+
+                            if (t.channels) {
+                                std::cout << "channels";
+                                knob("rx", t.channels->rx_count, t.channels->max_rx);
+                                knob("tx", t.channels->tx_count, t.channels->max_tx);
+                                knob("other", t.channels->other_count, t.channels->max_other);
+                                knob("combined", t.channels->combined_count, t.channels->max_combined);
+                            }
+                        });
+                    }
+
+                    if (t.coalesce)
+                    {
+                        pretty_printLn(std::cout, indent, [&]
+                        {
+                            auto &c = *t.coalesce;
+
+                            std::cout << "coalesce adaptive-rx:" << (c.use_adaptive_rx_coalesce ? "on" : "off")
+                                      << " adaptive-tx:" << (c.use_adaptive_tx_coalesce ? "on" : "off")
+                                      << " rx-usecs:" << c.rx_coalesce_usecs << " rx-frames:" << c.rx_max_coalesced_frames
+                                      << " tx-usecs:" << c.tx_coalesce_usecs << " tx-frames:" << c.tx_max_coalesced_frames;
+
+                            if (c.rx_coalesce_usecs_irq || c.rx_max_coalesced_frames_irq)
+                                std::cout << " rx-usecs-irq:" << c.rx_coalesce_usecs_irq << " rx-frames-irq:" << c.rx_max_coalesced_frames_irq;
+                            if (c.tx_coalesce_usecs_irq || c.tx_max_coalesced_frames_irq)
+                                std::cout << " tx-usecs-irq:" << c.tx_coalesce_usecs_irq << " tx-frames-irq:" << c.tx_max_coalesced_frames_irq;
+                            if (c.stats_block_coalesce_usecs)
+                                std::cout << " stats-block-usecs:" << c.stats_block_coalesce_usecs;
+                        });
+                    }
+                }
+
+                // ... display the common offloads (* = fixed) and the features whose
+                // requested state differs from the active one
+                //
+
+                if (fi != features.end())
+                {
+                    pretty_printLn(std::cout, indent, [&]
+                    {
+                        auto &f = fi->second;
+                        auto &names = ethtool::feature_names();
+
+                        size_t on = 0;
+                        std::string pending;
+
+                        for(size_t bit = 0; bit < names.size(); bit++)
+                        {
+                            bool active = ethtool::feature_set::test(f.active, bit);
+                            on += active;
+
+                            if (ethtool::feature_set::test(f.available, bit) &&
+                                ethtool::feature_set::test(f.requested, bit) != active)
+                                pending += ' ' + names[bit] + (active ? ":on(requested off)" : ":off(requested on)");
+                        }
+
+                        std::cout << "offload";
+
+                        for(size_t bit = 0; bit < names.size(); bit++)
+                        {
+                            auto alias = ethtool::feature_alias(bit);
+                            if (alias.empty())
+                                continue;
+
+                            std::cout << ' ' << alias << ':' << (ethtool::feature_set::test(f.active, bit) ? "on" : "off")
+                                      << (ethtool::feature_set::test(f.never_changed, bit) ? "*" : "");
+                        }
+
+                        std::cout << " active:" << on << '/' << names.size();
+
+                        if (!pending.empty())
+                            std::cout << std::endl << more::spaces(indent) << "pending" << pending;
+                    });
+                }
+
+                // ... display driver statistics (non-zero only), grouped by queue
+                //
+
+                if (info && info->n_stats)
+                {
+                    pretty_printLn(std::cout, indent, [&]
+                    {
+                        auto layout = ethtool::get_stats_layout(iif, *info);
+                        auto values = ethtool::get_stats(iif, *layout);
+
+                        int queue = -1;
+                        std::cout << "stats";
+
+                        for(auto i : layout->order)
+                        {
+                            if (values[i] == 0)
+                                continue;
+
+                            if (layout->queue[i] != queue) {
+                                queue = layout->queue[i];
+                                std::cout << std::endl << more::spaces(indent) << "queue " << queue;
+                            }
+
+                            std::cout << ' ' << layout->label[i] << ':' << values[i];
+                        }
+                    });
+                }
+
+                // ... display drvinfo if available (and the PCI info for devices on a PCI bus)
                 //
 
-                if (info)
+                if (info && plan.pci && (ki == kinds.end() || ki->second.pci))
                 {
                     pretty_printLn(std::cout, indent, [&]
                     {
-                        char bus_info[33] = {0};
-                       
-                        strncpy(bus_info, info->bus_info, sizeof(bus_info)-1);
+                        char bus_info[sizeof(info->bus_info) + 1] = {0};
+
+                        memcpy(bus_info, info->bus_info, sizeof(info->bus_info));
 
                         // set filter (and display additional pci info, if available)...
                         //
@@ -415,6 +635,9 @@ show_interfaces(const options &opts)
         }
     }
 
+    if (!cache.empty() && caps.dirty())
+        caps.save(cache);
+
     pci_cleanup(pacc);
     std::cout << reset();
     return 0;
@@ -426,6 +649,24 @@ const char usage_str[] = "\
 Usage:%s [options]\n\
   -a, --all            display all interfaces\n\
   -d, --driver NAME    filter by driver\n\
+  -F, --feature-missing NAME\n\
+                       filter the interfaces with feature NAME off (gro, tso, lro, rx-checksum...)\n\
+  -w, --watch SECS     display the rates every SECS seconds\n\
+  -c, --count N        stop watching after N samples\n\
+  -T, --tree           display the bond/bridge/vlan hierarchy and the rates (over --watch secs, default 1)\n\
+  -I, --irq            display the NIC IRQs, their affinity and the rates per CPU (over --watch secs, default 1)\n\
+                       and the per-CPU softnet backlog rates\n\
+  -N, --numa           display the NUMA locality of the NIC IRQs and RPS/XPS queues\n\
+  -Q, --queues         display the RPS/RFS/XPS configuration of the queues\n\
+  -H, --histogram      display p50/p90/p99/max of the rates at the end of --watch (or ^C)\n\
+                       or over the snapshots of the ring, with --shm\n\
+  -b, --burst MSECS    sample every MSECS ms, report peaks and bursts every --watch secs (default 1)\n\
+  -t, --top N          watch the N busiest interfaces only\n\
+  -s, --sort KEY       sort by rx_bps, rx_pps, tx_bps, tx_pps, drops or errors\n\
+  -S, --shm[=NAME]     read the rates from the ifshowd ring (default /ifshow)\n\
+  -o, --snapshot FILE  save the properties and counters of the interfaces to FILE (- for stdout)\n\
+  -D, --diff A B       display the differences between the snapshots A and B\n\
+  -n, --no-cache       don't load/save the driver capability cache\n\
   -v, --verbose        \n\
   -V, --version        display the version and exit\n\
   -h, --help           print this help\n";
@@ -433,6 +674,21 @@ Usage:%s [options]\n\
 
 static const struct option long_options[] = {
     {"driver",   required_argument, NULL, 'd'},
+    {"feature-missing", required_argument, NULL, 'F'},
+    {"watch",    required_argument, NULL, 'w'},
+    {"count",    required_argument, NULL, 'c'},
+    {"burst",    required_argument, NULL, 'b'},
+    {"histogram",no_argument, NULL, 'H'},
+    {"tree",     no_argument, NULL, 'T'},
+    {"irq",      no_argument, NULL, 'I'},
+    {"numa",     no_argument, NULL, 'N'},
+    {"queues",   no_argument, NULL, 'Q'},
+    {"top",      required_argument, NULL, 't'},
+    {"sort",     required_argument, NULL, 's'},
+    {"shm",      optional_argument, NULL, 'S'},
+    {"snapshot", required_argument, NULL, 'o'},
+    {"diff",     no_argument, NULL, 'D'},
+    {"no-cache", no_argument, NULL, 'n'},
     {"verbose",  no_argument, NULL, 'v'},
     {"version",  no_argument, NULL, 'V'},
     {"all",      no_argument, NULL, 'a'},
@@ -442,11 +698,12 @@ static const struct option long_options[] = {
 
 int
 main(int argc, char *argv[])
+try
 {
-    options opts = { {} , {} , false, false };
+    options opts;
 
     int i;
-    while ((i = getopt_long(argc, argv, "hVvad:", long_options, 0)) != EOF)
+    while ((i = getopt_long(argc, argv, "hVvaHTINQnDd:F:o:w:c:b:t:s:S::", long_options, 0)) != EOF)
         switch (i) {
         case 'h':
             printf(usage_str, __progname);
@@ -460,9 +717,65 @@ main(int argc, char *argv[])
         case 'v':
             opts.verbose=true;
             break;
+        case 'n':
+            opts.cache=false;
+            break;
+        case 'o':
+            opts.snapshot = optarg;
+            break;
+        case 'D':
+            opts.diff=true;
+            break;
         case 'd':
             opts.driver.push_back(optarg);
             break;
+        case 'F':
+            if (ethtool::feature_index(optarg) < 0)
+                throw std::runtime_error(std::string("unknown feature ") + optarg);
+            opts.feature_missing.push_back(optarg);
+            break;
+        case 'w':
+            opts.watch = strtod(optarg, nullptr);
+            if (opts.watch <= 0.0)
+                throw std::runtime_error("invalid watch interval");
+            break;
+        case 'c':
+            opts.count = strtoul(optarg, nullptr, 0);
+            break;
+        case 'N':
+            opts.numa=true;
+            break;
+        case 'Q':
+            opts.queues=true;
+            break;
+        case 'I':
+            opts.irq=true;
+            break;
+        case 'T':
+            opts.tree=true;
+            break;
+        case 'H':
+            opts.histogram=true;
+            break;
+        case 'b':
+            // at least 1us: the sampling period is in whole nanoseconds
+            //
+            opts.burst = strtod(optarg, nullptr);
+            if (!(opts.burst >= 0.001))
+                throw std::runtime_error("invalid burst interval (min 0.001 ms)");
+            break;
+        case 't':
+            opts.top = strtoul(optarg, nullptr, 0);
+            break;
+        case 's':
+            opts.sort = optarg;
+            if (opts.sort != "rx_bps" && opts.sort != "rx_pps" && opts.sort != "tx_bps" &&
+                opts.sort != "tx_pps" && opts.sort != "drops"  && opts.sort != "errors")
+                throw std::runtime_error("unknown sort key");
+            break;
+        case 'S':
+            opts.shm = !optarg ? shm::DEFAULT_NAME : optarg[0] == '/' ? optarg : std::string("/") + optarg;
+            break;
         case '?':
             throw std::runtime_error("unknown option");
         }
@@ -470,12 +783,52 @@ main(int argc, char *argv[])
     argc -= optind;
     argv += optind;
 
+    // names longer than IFNAMSIZ - 1 can't exist: ifname throws
+    //
     while( argc > 0 ) {
-        opts.if_list.push_back(std::string(argv[0]));
+        if (opts.diff)
+            opts.files.push_back(argv[0]);
+        else
+            opts.if_list.push_back(argv[0]);
         argc--;
         argv++;
     }
 
+    if ((opts.top || !opts.sort.empty()) && opts.watch <= 0.0 && opts.shm.empty())
+        throw std::runtime_error("--top and --sort require --watch or --shm");
+
+    if (opts.histogram && opts.watch <= 0.0 && opts.shm.empty())
+        throw std::runtime_error("--histogram requires --watch or --shm");
+
+    if (opts.diff)
+        return snapshot::diff_snapshots(opts);
+
+    if (!opts.snapshot.empty())
+        return snapshot::save_snapshot(opts);
+
+    if (opts.numa)
+        return watch::numa_interfaces(opts);
+
+    if (opts.queues)
+        return watch::queue_interfaces(opts);
+
+    if (opts.irq)
+        return watch::irq_interfaces(opts);
+
+    if (opts.tree)
+        return watch::tree_interfaces(opts);
+
+    if (opts.burst > 0.0)
+        return watch::burst_interfaces(opts);
+
+    if (opts.watch > 0.0 || !opts.shm.empty())
+        return watch::watch_interfaces(opts);
+
     return show_interfaces(opts);
 }
+catch(std::exception &e)
+{
+    std::cerr << __progname << ": " << e.what() << std::endl;
+    return 1;
+}
 
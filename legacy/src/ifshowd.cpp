@@ -0,0 +1,155 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+// ifshowd: sample the interface counters once, at a fixed rate, and publish
+// them in a shared memory ring (see shm/ring.hpp) for ifshow --shm and any
+// other reader.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+#include <csignal>
+#include <cstdlib>
+#include <getopt.h>
+
+#include <proc/net_dev.hpp>
+#include <sysfs/stats.hpp>
+#include <shm/ring.hpp>
+
+extern char *__progname;
+
+using namespace ifshow;
+
+static volatile sig_atomic_t stop;
+
+static void
+on_signal(int)
+{
+    stop = 1;
+}
+
+
+static
+const char usage_str[] = "\
+Usage:%s [options] [if...]\n\
+  -i, --interval SECS  sampling interval (default 1)\n\
+  -s, --slots N        snapshots kept in the ring (default 64)\n\
+  -n, --name NAME      shared memory name (default /ifshow)\n\
+  -h, --help           print this help\n";
+
+
+static const struct option long_options[] = {
+    {"interval", required_argument, NULL, 'i'},
+    {"slots",    required_argument, NULL, 's'},
+    {"name",     required_argument, NULL, 'n'},
+    {"help",     no_argument, NULL, 'h'},
+    { NULL,      0          , NULL,  0 }};
+
+
+int
+main(int argc, char *argv[])
+try
+{
+    double interval = 1.0;
+    unsigned long slots = 64;
+    std::string name = shm::DEFAULT_NAME;
+
+    int i;
+    while ((i = getopt_long(argc, argv, "hi:s:n:", long_options, 0)) != EOF)
+        switch (i) {
+        case 'h':
+            printf(usage_str, __progname);
+            exit(0);
+        case 'i':
+            interval = strtod(optarg, nullptr);
+            if (interval <= 0.0)
+                throw std::runtime_error("invalid interval");
+            break;
+        case 's':
+            slots = strtoul(optarg, nullptr, 0);
+            if (slots < 2 || slots > 65536)
+                throw std::runtime_error("invalid number of slots");
+            break;
+        case 'n':
+            name = optarg[0] == '/' ? optarg : std::string("/") + optarg;
+            break;
+        case '?':
+            throw std::runtime_error("unknown option");
+        }
+
+    // all the interfaces (up or down) unless a list is given
+    //
+    std::vector<ifname> list(argv + optind, argv + argc);
+
+    std::vector<ifname> ifs;
+    for(auto &n : proc::get_if_list())
+    {
+        if (list.empty() || std::find(list.begin(), list.end(), n) != list.end())
+            ifs.push_back(n);
+    }
+
+    if (ifs.empty())
+        throw std::runtime_error("no interface to sample");
+
+    sysfs::stats_sampler sampler(ifs);
+
+    auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(interval));
+
+    shm::writer ring(name, ifs, static_cast<uint32_t>(sampler.counters()), static_cast<uint32_t>(slots),
+                     static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(period).count()));
+
+    signal(SIGINT,  on_signal);
+    signal(SIGTERM, on_signal);
+
+    auto next = std::chrono::steady_clock::now();
+
+    // the last values read: a deleted interface keeps them, rather than
+    // dropping to 0 (which readers would take for a counter reset)
+    //
+    size_t nc = sampler.counters();
+    std::vector<uint64_t> last(sampler.size());
+
+    while (!stop)
+    {
+        // sample() doesn't throw: the slot is always completed
+        //
+        ring.publish([&](uint64_t *values) {
+            if (sampler.sample(values)) {
+                for(size_t i = 0; i < ifs.size(); i++)
+                    if (sampler.failed(i))
+                        std::copy(last.begin() + i * nc, last.begin() + (i + 1) * nc, values + i * nc);
+            }
+            std::copy(values, values + last.size(), last.begin());
+        });
+
+        next += period;
+        std::this_thread::sleep_until(next);
+    }
+
+    return 0;
+}
+catch(std::exception &e)
+{
+    std::cerr << __progname << ": " << e.what() << std::endl;
+    return 1;
+}
+
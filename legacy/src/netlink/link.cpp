@@ -0,0 +1,227 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+
+#include <netlink/link.hpp>
+
+namespace ifshow { namespace netlink {
+
+    // one socket per thread: the replies are read by the thread that sent
+    // the request (libifshow collectors may be sampled concurrently)
+    //
+    struct socket_
+    {
+        int fd, error;
+
+        socket_()
+        : fd(socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE))
+        , error(fd == -1 ? errno : 0)
+        {}
+
+        ~socket_()
+        {
+            if (fd != -1)
+                ::close(fd);
+        }
+    };
+
+
+    static int
+    sock_()
+    {
+        thread_local socket_ sock;
+        if (sock.fd == -1)
+            throw std::system_error(sock.error, std::generic_category());
+        return sock.fd;
+    }
+
+
+    template <typename T>
+    static T
+    rta_get(const struct rtattr *rta)
+    {
+        T value = 0;
+        memcpy(&value, RTA_DATA(rta), std::min<size_t>(RTA_PAYLOAD(rta), sizeof(T)));
+        return value;
+    }
+
+
+    // the kind specific attributes of IFLA_INFO_DATA
+    //
+    static void
+    parse_info_data(const struct rtattr *data, link &l)
+    {
+        int len = static_cast<int>(RTA_PAYLOAD(data));
+        for(auto rta = static_cast<const struct rtattr *>(RTA_DATA(data)); RTA_OK(rta, len); rta = RTA_NEXT(rta, len))
+        {
+            if (l.kind == "vlan" && rta->rta_type == IFLA_VLAN_ID)
+                l.kind_id = rta_get<uint16_t>(rta);
+            else if (l.kind == "vxlan" && rta->rta_type == IFLA_VXLAN_ID)
+                l.kind_id = static_cast<int>(rta_get<uint32_t>(rta));
+            else if (l.kind == "vxlan" && rta->rta_type == IFLA_VXLAN_LINK)
+                l.lower = static_cast<int>(rta_get<uint32_t>(rta));
+            else if (l.kind == "bond" && rta->rta_type == IFLA_BOND_MODE)
+                l.kind_mode = rta_get<uint8_t>(rta);
+            else if ((l.kind == "macvlan" || l.kind == "macvtap") && rta->rta_type == IFLA_MACVLAN_MODE)
+                l.kind_mode = static_cast<int>(rta_get<uint32_t>(rta));
+            else if (l.kind == "tun" && rta->rta_type == IFLA_TUN_TYPE)
+                l.kind_mode = rta_get<uint8_t>(rta);
+        }
+    }
+
+
+    static void
+    parse_linkinfo(const struct rtattr *info, link &l)
+    {
+        const struct rtattr *data = nullptr;
+
+        int len = static_cast<int>(RTA_PAYLOAD(info));
+        for(auto rta = static_cast<const struct rtattr *>(RTA_DATA(info)); RTA_OK(rta, len); rta = RTA_NEXT(rta, len))
+        {
+            switch(rta->rta_type)
+            {
+            case IFLA_INFO_KIND:
+                l.kind = static_cast<const char *>(RTA_DATA(rta));
+                break;
+            case IFLA_INFO_DATA:
+                data = rta;
+                break;
+            }
+        }
+
+        if (data)
+            parse_info_data(data, l);
+    }
+
+
+    static void
+    parse_link(const struct nlmsghdr *nlh, std::vector<link> &ret)
+    {
+        auto ifi = static_cast<const struct ifinfomsg *>(NLMSG_DATA(nlh));
+
+        link l;
+        l.index = ifi->ifi_index;
+        l.flags = ifi->ifi_flags;
+        l.type = ifi->ifi_type;
+        l.master = 0;
+        l.lower = 0;
+        l.kind_id = -1;
+        l.kind_mode = -1;
+        l.has_stats = false;
+        memset(&l.stats, 0, sizeof(l.stats));
+
+        int len = static_cast<int>(IFLA_PAYLOAD(nlh));
+        for(auto rta = IFLA_RTA(ifi); RTA_OK(rta, len); rta = RTA_NEXT(rta, len))
+        {
+            switch(rta->rta_type)
+            {
+            case IFLA_IFNAME:
+                l.name = static_cast<const char *>(RTA_DATA(rta));
+                break;
+            case IFLA_MASTER:
+                l.master = static_cast<int>(rta_get<uint32_t>(rta));
+                break;
+            case IFLA_LINK:
+                l.lower = static_cast<int>(rta_get<uint32_t>(rta));
+                break;
+            case IFLA_LINKINFO:
+                parse_linkinfo(rta, l);
+                break;
+            case IFLA_STATS64:
+                memcpy(&l.stats, RTA_DATA(rta), std::min<size_t>(RTA_PAYLOAD(rta), sizeof(l.stats)));
+                l.has_stats = true;
+                break;
+            }
+        }
+
+        ret.push_back(std::move(l));
+    }
+
+
+    std::vector<link>
+    get_links()
+    {
+        static std::atomic<unsigned int> seq;
+
+        struct {
+            struct nlmsghdr  nlh;
+            struct ifinfomsg ifi;
+        } req;
+
+        memset(&req, 0, sizeof(req));
+        req.nlh.nlmsg_len   = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+        req.nlh.nlmsg_type  = RTM_GETLINK;
+        req.nlh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+        req.nlh.nlmsg_seq   = ++seq;
+        req.ifi.ifi_family  = AF_UNSPEC;
+
+        if (send(sock_(), &req, req.nlh.nlmsg_len, 0) == -1)
+            throw std::system_error(errno, std::generic_category());
+
+        std::vector<link> ret;
+
+        // large enough for any dump chunk the kernel sends
+        //
+        alignas(struct nlmsghdr) char buf[32768];
+
+        for(;;)
+        {
+            ssize_t n = recv(sock_(), buf, sizeof(buf), 0);
+            if (n == -1) {
+                if (errno == EINTR)
+                    continue;
+                throw std::system_error(errno, std::generic_category());
+            }
+
+            int len = static_cast<int>(n);
+            for(auto nlh = reinterpret_cast<struct nlmsghdr *>(buf); NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len))
+            {
+                if (nlh->nlmsg_seq != req.nlh.nlmsg_seq)
+                    continue;
+
+                switch(nlh->nlmsg_type)
+                {
+                case NLMSG_DONE:
+                    return ret;
+                case NLMSG_ERROR: {
+                    auto err = static_cast<const struct nlmsgerr *>(NLMSG_DATA(nlh));
+                    throw std::system_error(-err->error, std::generic_category());
+                }
+                case RTM_NEWLINK:
+                    parse_link(nlh, ret);
+                    break;
+                }
+            }
+        }
+    }
+
+} // namespace netlink
+} // namespace ifshow
+
@@ -0,0 +1,52 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <linux/if_link.h>
+
+#include <string>
+#include <vector>
+
+#include <ifname.hpp>
+
+namespace ifshow { namespace netlink {
+
+    struct link
+    {
+        int                         index;
+        unsigned int                flags;
+        unsigned short              type;       // ARPHRD_*
+        ifname                      name;
+        std::string                 kind;       // IFLA_INFO_KIND (veth, bridge, vlan...), empty for devices
+        int                         master;     // IFLA_MASTER (bridge, bond), 0 if none
+        int                         lower;      // IFLA_LINK (vlan, macvlan, veth peer, vxlan dev), 0 if none
+        int                         kind_id;    // vlan id or vxlan vni, -1 if none
+        int                         kind_mode;  // bond, macvlan mode or tun type, -1 if none
+        bool                        has_stats;
+        struct rtnl_link_stats64    stats;
+    };
+
+    // dump all the links (RTM_GETLINK) with a single request
+    //
+    extern std::vector<link> get_links();
+
+} // namespace netlink
+} // namespace ifshow
+
@@ -0,0 +1,68 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#include <unordered_map>
+
+#include <netlink/topology.hpp>
+
+namespace ifshow { namespace netlink {
+
+    topology
+    make_topology(std::vector<link> links)
+    {
+        topology ret;
+        ret.links = std::move(links);
+        ret.nodes.resize(ret.links.size());
+
+        std::unordered_map<int, size_t> pos;
+        pos.reserve(ret.links.size());
+
+        for(size_t i = 0; i < ret.links.size(); i++)
+            pos.emplace(ret.links[i].index, i);
+
+        for(size_t i = 0; i < ret.links.size(); i++)
+        {
+            auto &l = ret.links[i];
+
+            if (l.master) {
+                auto it = pos.find(l.master);
+                if (it != pos.end() && it->second != i) {
+                    ret.nodes[it->second].slaves.push_back(i);
+                    ret.nodes[i].has_parent = true;
+                }
+            }
+
+            if (l.lower && l.kind != "veth") {
+                auto it = pos.find(l.lower);
+                if (it != pos.end() && it->second != i) {
+                    ret.nodes[i].lowers.push_back(it->second);
+                    ret.nodes[it->second].has_parent = true;
+                }
+            }
+        }
+
+        for(size_t i = 0; i < ret.nodes.size(); i++)
+            if (!ret.nodes[i].has_parent)
+                ret.roots.push_back(i);
+
+        return ret;
+    }
+
+} // namespace netlink
+} // namespace ifshow
+
@@ -0,0 +1,62 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <netlink/link.hpp>
+
+namespace ifshow { namespace netlink {
+
+    /*
+     * The stacking of the interfaces, from a single link dump. Upper devices
+     * are parents of the lower ones:
+     *
+     *   - a bond/bridge master is the parent of its slaves (IFLA_MASTER);
+     *     the slaves of a master form a proper tree and their rates add up;
+     *
+     *   - a vlan, macvlan or vxlan is the parent of the device it is stacked
+     *     on (IFLA_LINK); a lower device can carry several uppers, so it may
+     *     appear under more than one parent and its rate is not additive.
+     *
+     * veth peers are not a hierarchy and are ignored.
+     */
+
+    struct topology
+    {
+        struct node
+        {
+            std::vector<size_t> slaves;     // by IFLA_MASTER
+            std::vector<size_t> lowers;     // by IFLA_LINK
+            bool                has_parent = false;
+        };
+
+        std::vector<link>   links;
+        std::vector<node>   nodes;          // nodes[i] refers to links[i]
+        std::vector<size_t> roots;          // the topmost devices
+    };
+
+    // build the topology in O(N)
+    //
+    extern topology make_topology(std::vector<link> links);
+
+} // namespace netlink
+} // namespace ifshow
+
@@ -0,0 +1,50 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <ifname.hpp>
+
+struct options
+{
+    std::vector<ifshow::ifname> if_list;
+    std::vector<std::string>    files;          // the snapshots to compare with --diff
+    std::vector<std::string>    driver;
+    std::vector<std::string>    feature_missing;    // filter the interfaces missing one of these features
+    bool                        verbose = false;
+    bool                        all = false;
+    bool                        cache = true;   // load/save the driver capability cache
+    double                      watch = 0.0;    // seconds between samples, 0 = no watch
+    unsigned long               count = 0;      // number of samples in watch mode, 0 = forever
+    bool                        tree = false;       // display the interface hierarchy
+    bool                        irq = false;        // display the IRQs of the NICs
+    bool                        numa = false;       // display the NUMA locality of the NIC queues
+    bool                        queues = false;     // display the RPS/RFS/XPS configuration of the queues
+    bool                        histogram = false;  // display the distribution of the rates
+    double                      burst = 0.0;    // milliseconds between samples in burst mode, 0 = no burst
+    size_t                      top = 0;        // display the busiest N interfaces only, 0 = all
+    std::string                 sort;           // rx_bps, rx_pps, tx_bps, tx_pps, drops or errors
+    std::string                 shm;            // read the counters from the ifshowd ring with this name
+    std::string                 snapshot;       // save a snapshot of the interfaces to this file ("-" for stdout)
+    bool                        diff = false;   // compare the two snapshot files in files
+};
+
@@ -0,0 +1,164 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+#include <probe/caps.hpp>
+
+namespace ifshow { namespace probe {
+
+    bool
+    capability_cache::unsupported(const std::string &key, capability c) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_unsupported.find(key);
+        return it != m_unsupported.end() && (it->second & (1U << c));
+    }
+
+
+    void
+    capability_cache::learn(const std::string &key, capability c)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto &mask = m_unsupported[key];
+        if (!(mask & (1U << c))) {
+            mask |= 1U << c;
+            m_dirty = true;
+        }
+    }
+
+
+    /*
+     * one line per driver: driver <tab> version <tab> capability...
+     */
+
+    void
+    capability_cache::load(const std::string &path)
+    {
+        std::ifstream in(path);
+        std::string line;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        while (std::getline(in, line))
+        {
+            auto t1 = line.find('\t');
+            if (t1 == std::string::npos)
+                continue;
+            auto t2 = line.find('\t', t1 + 1);
+
+            std::string key = line.substr(0, t1) + ' ' + line.substr(t1 + 1, t2 == std::string::npos ? std::string::npos : t2 - t1 - 1);
+
+            unsigned int mask = 0;
+            while (t2 != std::string::npos)
+            {
+                auto b = t2 + 1;
+                t2 = line.find('\t', b);
+                auto cap = line.substr(b, t2 == std::string::npos ? std::string::npos : t2 - b);
+
+                for(unsigned int c = 0; c < max_capability; c++)
+                    if (cap == capability_name[c])
+                        mask |= 1U << c;
+            }
+
+            if (mask)
+                m_unsupported[key] |= mask;
+        }
+    }
+
+
+    void
+    capability_cache::save(const std::string &path) const
+    {
+        // create the missing directories (e.g. ~/.cache/ifshow)
+        //
+        for(auto slash = path.find('/', 1); slash != std::string::npos; slash = path.find('/', slash + 1))
+            mkdir(path.substr(0, slash).c_str(), 0755);
+
+        // write a temporary and rename it, so that concurrent runs never
+        // read a partial file
+        //
+        std::string tmp = path + '.' + std::to_string(getpid());
+        {
+            std::ofstream out(tmp);
+            if (!out)
+                return;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            for(auto &[key, mask] : m_unsupported)
+            {
+                auto sp = key.find(' ');
+                out << key.substr(0, sp) << '\t' << (sp == std::string::npos ? "" : key.substr(sp + 1));
+
+                for(unsigned int c = 0; c < max_capability; c++)
+                    if (mask & (1U << c))
+                        out << '\t' << capability_name[c];
+
+                out << '\n';
+            }
+
+            if (!out.flush()) {
+                unlink(tmp.c_str());
+                return;
+            }
+        }
+
+        if (rename(tmp.c_str(), path.c_str()) < 0)
+            unlink(tmp.c_str());
+    }
+
+
+    std::string
+    driver_key(const ethtool_drvinfo &info)
+    {
+        return std::string(info.driver) + ' ' + info.version;
+    }
+
+
+    std::string
+    cache_path()
+    {
+        if (auto xdg = getenv("XDG_CACHE_HOME"); xdg && *xdg == '/')
+            return std::string(xdg) + "/ifshow/capabilities";
+
+        if (auto home = getenv("HOME"); home && *home)
+            return std::string(home) + "/.cache/ifshow/capabilities";
+
+        return std::string();
+    }
+
+
+    capability_cache &
+    capabilities()
+    {
+        static capability_cache cache;
+        return cache;
+    }
+
+} // namespace probe
+} // namespace ifshow
+
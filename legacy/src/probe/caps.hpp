@@ -0,0 +1,110 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#pragma once
+
+#include <linux/ethtool.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <result.hpp>
+
+namespace ifshow { namespace probe {
+
+    enum capability
+    {
+        ethtool_gset,       // ETHTOOL_GSET
+        ethtool_glink,      // ETHTOOL_GLINK
+        ifmap,              // SIOCGIFMAP
+        wireless_ext,       // wireless extensions
+        max_capability
+    };
+
+    static const char * const capability_name[] =
+    {
+        "ethtool_gset", "ethtool_glink", "ifmap", "wireless"
+    };
+
+    /*
+     * The probes a driver does not implement (EOPNOTSUPP/ENOTTY), keyed by
+     * driver name and version. The cache is learned at runtime and can be
+     * persisted, so that repeated runs skip the probes known to fail.
+     */
+
+    class capability_cache
+    {
+    public:
+        capability_cache() = default;
+
+        capability_cache(const capability_cache &) = delete;
+        capability_cache & operator=(const capability_cache &) = delete;
+
+        // run fun() (returning a result<T>) unless the driver is known not
+        // to support the capability; an empty key disables the cache
+        //
+        template <typename Fun>
+        auto attempt(const std::string &key, capability c, Fun fun) -> decltype(fun())
+        {
+            if (!key.empty() && unsupported(key, c))
+                return fail(EOPNOTSUPP);
+
+            auto ret = fun();
+            if (!ret && ret.unsupported() && !key.empty())
+                learn(key, c);
+
+            return ret;
+        }
+
+        bool unsupported(const std::string &key, capability c) const;
+
+        void learn(const std::string &key, capability c);
+
+        // load/save the cache, errors are ignored (it's just a cache)
+        //
+        void load(const std::string &path);
+        void save(const std::string &path) const;
+
+        bool dirty() const
+        {
+            return m_dirty;
+        }
+
+    private:
+        mutable std::mutex                  m_mutex;
+        std::map<std::string, unsigned int> m_unsupported;  // bitmask of capabilities
+        bool                                m_dirty = false;
+    };
+
+
+    // the key of the driver of an interface: "driver version"
+    //
+    extern std::string driver_key(const ethtool_drvinfo &info);
+
+    // $XDG_CACHE_HOME/ifshow/capabilities (or ~/.cache/...), empty if unknown
+    //
+    extern std::string cache_path();
+
+    // the process-wide cache
+    //
+    extern capability_cache & capabilities();
+
+} // namespace probe
+} // namespace ifshow
+
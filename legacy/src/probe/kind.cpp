@@ -0,0 +1,179 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#include <net/if_arp.h>
+#include <net/if.h>
+#include <linux/if_link.h>
+#include <linux/if_tun.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <climits>
+#include <cstdlib>
+#include <sstream>
+
+#include <sysfs/files.hpp>
+#include <probe/kind.hpp>
+
+namespace ifshow { namespace probe {
+
+    probe_plan
+    get_probe_plan(if_kind kind)
+    {
+        switch(kind)
+        {
+        case loopback:  return probe_plan { false, false, false, false };
+        case physical:  return probe_plan { true,  true,  false, true  };
+        case wireless:  return probe_plan { true,  true,  true,  true  };
+        case veth:
+        case bridge:
+        case bond:
+        case vlan:
+        case macvlan:
+        case tun:
+        case vxlan:     return probe_plan { true,  true,  false, false };
+        case other:     return probe_plan { true,  false, false, false };
+        default:        return probe_plan { true,  true,  true,  true  };
+        }
+    }
+
+
+    static if_kind
+    virtual_kind(const std::string &kind)
+    {
+        for(int k = veth; k < other; k++)
+            if (kind == kind_name[k])
+                return static_cast<if_kind>(k);
+
+        return kind == "macvtap" ? macvlan : other;
+    }
+
+
+    static bool
+    exists(const std::string &path)
+    {
+        struct stat st;
+        return stat(path.c_str(), &st) == 0;
+    }
+
+
+    std::map<ifname, interface>
+    classify()
+    {
+        std::map<ifname, interface> ret;
+
+        for(auto &l : netlink::get_links())
+        {
+            interface i { unknown, false, l };
+
+            std::string dir = std::string(sysfs::CLASS_NET) + '/' + l.name.c_str();
+
+            if ((l.flags & IFF_LOOPBACK) || l.type == ARPHRD_LOOPBACK)
+                i.kind = loopback;
+            else if (!l.kind.empty())
+                i.kind = virtual_kind(l.kind);
+            else if (exists(dir + "/device"))
+            {
+                i.kind = exists(dir + "/wireless") || exists(dir + "/phy80211") ? wireless : physical;
+
+                char path[PATH_MAX];
+                if (realpath((dir + "/device").c_str(), path))
+                    i.pci = std::string(path).compare(0, 16, "/sys/devices/pci") == 0;
+            }
+            else
+                i.kind = other;
+
+            ret.emplace(l.name, std::move(i));
+        }
+
+        return ret;
+    }
+
+
+    static std::string
+    if_name(int index, const std::map<ifname, interface> &all)
+    {
+        for(auto &[name, i] : all)
+            if (i.link.index == index)
+                return name;
+
+        // e.g. the peer of a veth in another namespace
+        //
+        return "#" + std::to_string(index);
+    }
+
+
+    static const char *
+    mode_name(const interface &i)
+    {
+        static const char * const bond_mode[] =
+        {
+            "balance-rr", "active-backup", "balance-xor", "broadcast", "802.3ad", "balance-tlb", "balance-alb"
+        };
+
+        int mode = i.link.kind_mode;
+
+        switch(i.kind)
+        {
+        case bond:
+            return mode >= 0 && mode < 7 ? bond_mode[mode] : nullptr;
+        case macvlan:
+            switch(mode)
+            {
+            case MACVLAN_MODE_PRIVATE:  return "private";
+            case MACVLAN_MODE_VEPA:     return "vepa";
+            case MACVLAN_MODE_BRIDGE:   return "bridge";
+            case MACVLAN_MODE_PASSTHRU: return "passthru";
+            case MACVLAN_MODE_SOURCE:   return "source";
+            }
+            return nullptr;
+        case tun:
+            return mode == IFF_TUN ? "tun" : mode == IFF_TAP ? "tap" : nullptr;
+        default:
+            return nullptr;
+        }
+    }
+
+
+    std::string
+    kind_details(const interface &i, const std::map<ifname, interface> &all)
+    {
+        std::ostringstream out;
+
+        // the other virtual kinds by their own name (dummy, ifb, gre...)
+        //
+        out << (i.kind == other && !i.link.kind.empty() ? i.link.kind.c_str() : kind_name[i.kind]);
+
+        if (i.link.kind_id >= 0)
+            out << (i.kind == vxlan ? " vni:" : " id:") << i.link.kind_id;
+
+        if (auto mode = mode_name(i))
+            out << (i.kind == tun ? " type:" : " mode:") << mode;
+
+        if (i.link.lower)
+            out << (i.kind == veth ? " peer:" : " link:") << if_name(i.link.lower, all);
+
+        if (i.link.master)
+            out << " master:" << if_name(i.link.master, all);
+
+        return out.str();
+    }
+
+} // namespace probe
+} // namespace ifshow
+
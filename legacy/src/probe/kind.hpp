@@ -0,0 +1,83 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#pragma once
+
+#include <map>
+#include <string>
+
+#include <netlink/link.hpp>
+
+#include <ifname.hpp>
+
+namespace ifshow { namespace probe {
+
+    enum if_kind
+    {
+        unknown,            // not in the link dump
+        loopback,
+        physical,           // backed by a device (PCI or other bus)
+        wireless,
+        veth,
+        bridge,
+        bond,
+        vlan,
+        macvlan,
+        tun,
+        vxlan,
+        other,              // any other virtual kind (dummy, ifb, gre...)
+        max_kind
+    };
+
+    static const char * const kind_name[] =
+    {
+        "unknown", "loopback", "physical", "wireless", "veth", "bridge", "bond",
+        "vlan", "macvlan", "tun", "vxlan", "other"
+    };
+
+    // the probes that can succeed on a kind of interface
+    //
+    struct probe_plan
+    {
+        bool    drvinfo;        // ETHTOOL_GDRVINFO (and driver statistics)
+        bool    link_settings;  // ETHTOOL_GSET, ETHTOOL_GLINK
+        bool    wireless;       // wireless extensions
+        bool    pci;            // PCI lookup by bus info
+    };
+
+    struct interface
+    {
+        if_kind         kind;
+        bool            pci;            // the device sits on a PCI bus
+        netlink::link   link;
+    };
+
+    extern probe_plan get_probe_plan(if_kind kind);
+
+    // classify all the interfaces with a single link dump (plus a couple of
+    // stat() in sysfs for the devices)
+    //
+    extern std::map<ifname, interface> classify();
+
+    // the kind specific details, e.g. "vlan id:100 link:eth0 master:br0"
+    //
+    extern std::string kind_details(const interface &i, const std::map<ifname, interface> &all);
+
+} // namespace probe
+} // namespace ifshow
+
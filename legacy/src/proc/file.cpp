@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <system_error>
+
+#include <proc/file.hpp>
+
+namespace ifshow { namespace proc {
+
+    result<std::string>
+    try_read_file(const char *path)
+    {
+        int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd == -1)
+            return fail(errno);
+
+        std::string buf(16384, '\0');
+        size_t len = 0;
+
+        for(;;)
+        {
+            if (len == buf.size())
+                buf.resize(buf.size() * 2);
+
+            ssize_t n = ::read(fd, &buf[len], buf.size() - len);
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                int err = errno;
+                ::close(fd);
+                return fail(err);
+            }
+            if (n == 0)
+                break;
+            len += static_cast<size_t>(n);
+        }
+
+        ::close(fd);
+        buf.resize(len);
+        return buf;
+    }
+
+
+    std::string
+    read_file(const char *path)
+    {
+        auto buf = try_read_file(path);
+        if (!buf)
+            throw std::system_error(buf.error(), std::generic_category(), path);
+        return std::move(*buf);
+    }
+
+} // namespace proc
+} // namespace ifshow
+
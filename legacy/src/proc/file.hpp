@@ -0,0 +1,40 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <string>
+
+#include <proc/files.hpp>
+#include <result.hpp>
+
+namespace ifshow { namespace proc {
+
+    // the whole content of a /proc file with read(2) (the seq_file
+    // interface returns a few pages per call); throws std::system_error
+    //
+    extern std::string read_file(const char *path);
+
+    // as read_file, for the files that may be missing (/proc/net/wireless)
+    //
+    extern result<std::string> try_read_file(const char *path);
+
+} // namespace proc
+} // namespace ifshow
+
@@ -25,6 +25,7 @@ namespace ifshow { namespace proc {
     static const char NET_DEV   []= "/proc/net/dev";
     static const char NET_WIRELESS []= "/proc/net/wireless";
     static const char IFINET6   []= "/proc/net/if_inet6";
+    static const char SOFTNET_STAT []= "/proc/net/softnet_stat";
 
 } // namespace proc
 } // namespace ifshow
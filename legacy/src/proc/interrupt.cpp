@@ -17,54 +17,194 @@
  *
  */
 
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdlib>
+
 #include <iomanip.hpp>
 
+#include <proc/file.hpp>
 #include <proc/interrupt.hpp>
+#include <sysfs/irq.hpp>
 
 namespace ifshow { namespace proc {
 
+    // the header has one "CPUn" column per online CPU: the CPU id of each
+    // column (offline CPUs leave gaps, e.g. "CPU0 CPU2 CPU3")
+    //
+    static std::vector<int>
+    get_cpu_columns(std::string_view header)
+    {
+        std::vector<int> ret;
+        for(auto tok : more::tokens(header, " "))
+        {
+            if (tok.size() < 4 || tok.compare(0, 3, "CPU") != 0)
+                continue;
+            int cpu;
+            auto r = std::from_chars(tok.data() + 3, tok.data() + tok.size(), cpu);
+            if (r.ec == std::errc())
+                ret.push_back(cpu);
+        }
+        return ret;
+    }
+
+
     std::vector<int>
     get_interrupt_counter(int irq)
     {
-        std::ifstream proc_interrupt(proc::INTERRUPT);
+        auto buf = read_file(proc::INTERRUPT);
         std::vector<int> ret;
 
-        // skip the first line...
-        //
+        more::tokenizer lines(buf, "\n");
+        std::string_view line;
 
-        proc_interrupt >> more::ignore_line;
+        if (!lines.next(line))
+            return ret;
 
-        more::string_token intstr(":");
+        auto cpus = get_cpu_columns(line);
 
-        while( proc_interrupt >> intstr )
+        while (lines.next(line))
         {
-            int intnum;
+            auto colon = line.find(':');
+            if (colon == std::string_view::npos)
+                continue;
 
-            try
-            {
-                intnum = more::lexical_cast<int>(static_cast<std::string>(intstr));
-            }
-            catch(...)
-            {
-                proc_interrupt >> more::ignore_line;
+            // NMI, LOC... are not numbers
+            //
+            if (more::try_lexical_cast<int>(line.substr(0, colon)) != irq)
                 continue;
+
+            // the per-CPU counters, up to the description
+            //
+            more::tokenizer fields(line.substr(colon + 1), " ");
+            std::string_view value;
+            for(size_t c = 0; c < cpus.size() && fields.next(value); )
+            {
+                if (value.empty())
+                    continue;
+                if (value.find_first_not_of("0123456789") != std::string_view::npos)
+                    break;
+                if (ret.size() <= static_cast<size_t>(cpus[c]))
+                    ret.resize(cpus[c] + 1);
+                ret[cpus[c++]] = static_cast<int>(strtol(value.data(), nullptr, 10));
             }
 
-            if (intnum != irq) {
-                proc_interrupt >> more::ignore_line;
+            break;
+        }
+
+        return ret;
+    }
+
+
+    std::string
+    interrupt::name() const
+    {
+        auto e = desc.find_last_not_of(" \t");
+        if (e == std::string::npos)
+            return std::string();
+        auto b = desc.find_last_of(" \t", e);
+        return desc.substr(b == std::string::npos ? 0 : b + 1, e - (b == std::string::npos ? 0 : b + 1) + 1);
+    }
+
+
+    std::vector<interrupt>
+    get_interrupts()
+    {
+        auto buf = read_file(proc::INTERRUPT);
+        std::vector<interrupt> ret;
+
+        more::tokenizer lines(buf, "\n");
+        std::string_view line;
+
+        if (!lines.next(line))
+            return ret;
+
+        auto cpus = get_cpu_columns(line);
+        int ncpu = cpus.empty() ? 0 : *std::max_element(cpus.begin(), cpus.end()) + 1;
+
+        while (lines.next(line))
+        {
+            auto colon = line.find(':');
+            if (colon == std::string_view::npos)
                 continue;
+
+            interrupt i;
+            i.irq = more::trim_view(line.substr(0, colon));
+            // the counters are followed by the description (ERR/MIS have a
+            // single counter)
+            //
+            const char *p = line.data() + colon + 1, *end = line.data() + line.size();
+            for(size_t c = 0; c < cpus.size(); c++)
+            {
+                while (p != end && *p == ' ')
+                    p++;
+                uint64_t value;
+                auto r = std::from_chars(p, end, value);
+                if (r.ec != std::errc())
+                    break;
+                if (i.count.empty())
+                    i.count.resize(ncpu);
+                i.count[cpus[c]] = value;
+                p = r.ptr;
             }
 
-            int value;
-            while( proc_interrupt >> value )
-                 ret.push_back(value);
+            while (p != end && *p == ' ')
+                p++;
+            i.desc.assign(p, end);
 
-            break;
+            ret.push_back(std::move(i));
         }
 
         return ret;
     }
 
+
+    // the description of the IRQ names the interface (e.g. "eth0-TxRx-0")
+    //
+    static bool
+    names_interface(const std::string &desc, const std::string &ifname)
+    {
+        for(auto pos = desc.find(ifname); pos != std::string::npos; pos = desc.find(ifname, pos + 1))
+        {
+            bool begin = pos == 0 || !isalnum(static_cast<unsigned char>(desc[pos - 1]));
+            bool end   = pos + ifname.size() == desc.size() || !isalnum(static_cast<unsigned char>(desc[pos + ifname.size()]));
+            if (begin && end)
+                return true;
+        }
+        return false;
+    }
+
+
+    std::vector<int>
+    get_interface_irqs(const std::string &ifname, const std::vector<proc::interrupt> &table)
+    {
+        auto ret = sysfs::get_device_irqs(ifname);
+
+        for(auto &i : table)
+        {
+            auto irq = more::try_lexical_cast<int>(i.irq);
+            if (!irq || !names_interface(i.desc, ifname))
+                continue;
+
+            if (std::find(ret.begin(), ret.end(), *irq) == ret.end())
+                ret.push_back(*irq);
+        }
+
+        std::sort(ret.begin(), ret.end());
+        return ret;
+    }
+
+
+    std::string
+    get_irq_affinity(int irq, bool effective)
+    {
+        std::ifstream in("/proc/irq/" + std::to_string(irq) + (effective ? "/effective_affinity_list" : "/smp_affinity_list"));
+        std::string ret;
+        std::getline(in, ret);
+        return ret;
+    }
+
 } // namespace proc
 } // namespace ifshow
 
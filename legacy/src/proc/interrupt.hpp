@@ -31,8 +31,36 @@
 
 namespace ifshow { namespace proc
 {
+    // the counters of an IRQ, indexed by CPU id (0 for the offline CPUs)
+    //
     extern std::vector<int> get_interrupt_counter(int irq);
 
+    // a line of /proc/interrupts
+    //
+    struct interrupt
+    {
+        std::string             irq;        // "41", "NMI"...
+        std::vector<uint64_t>   count;      // by CPU id, 0 if offline
+        std::string             desc;       // chip, hwirq and actions
+
+        // the last field of desc (e.g. "virtio3-output.0", "eth0-TxRx-3")
+        //
+        std::string name() const;
+    };
+
+    // parse the whole /proc/interrupts table
+    //
+    extern std::vector<interrupt> get_interrupts();
+
+    // the IRQs of an interface: those of its device and those whose
+    // description names it in /proc/interrupts
+    //
+    extern std::vector<int> get_interface_irqs(const std::string &ifname, const std::vector<interrupt> &table);
+
+    // /proc/irq/N/smp_affinity_list or effective_affinity_list ("" if not available)
+    //
+    extern std::string get_irq_affinity(int irq, bool effective = false);
+
 } // namespace proc
 } // namespace ifshow
 
@@ -18,33 +18,47 @@
  */
 
 
-#include <iomanip.hpp>
 #include <string-utils.hpp>
 
+#include <proc/file.hpp>
 #include <proc/net_dev.hpp>
 
 namespace ifshow { namespace proc {
 
-    std::list<std::string>
-    get_if_list()
+    std::vector<ifname>
+    parse_if_list(std::string_view buf)
     {
-        std::ifstream proc_net_dev(proc::NET_DEV);
-        std::list<std::string> ret;
+        std::vector<ifname> ret;
+
+        more::tokenizer lines(buf, "\n");
+        std::string_view line;
 
         // skip the first 2 lines
         //
-        proc_net_dev >> more::ignore_line >> more::ignore_line;
+        lines.next(line);
+        lines.next(line);
 
-        more::string_token if_name(":");
-        while (proc_net_dev >> if_name)
+        // "  eth0: 1234 ...": the name is right-aligned before the colon
+        //
+        while (lines.next(line))
         {
-            ret.push_back(more::trim_copy(if_name.str()));
-            proc_net_dev >> more::ignore_line;
+            auto colon = line.find(':');
+            if (colon == std::string_view::npos)
+                continue;
+
+            ret.emplace_back(more::trim_view(line.substr(0, colon)));
         }
 
         return ret;
     }
 
+
+    std::vector<ifname>
+    get_if_list()
+    {
+        return parse_if_list(read_file(NET_DEV));
+    }
+
 } // namespace proc
 } // namespace ifshow
 
@@ -22,14 +22,21 @@
 #include <fstream>
 #include <sstream>
 #include <string>
-#include <list>
+#include <string_view>
+#include <vector>
 
 #include <string-utils.hpp>
 #include <proc/files.hpp>
 
+#include <ifname.hpp>
+
 namespace ifshow { namespace proc {
 
-    extern std::list<std::string> get_if_list();
+    // the interfaces in /proc/net/dev order
+    //
+    extern std::vector<ifname> get_if_list();
+
+    extern std::vector<ifname> parse_if_list(std::string_view buf);
 
 } // namespace proc
 } // namespace ifshow
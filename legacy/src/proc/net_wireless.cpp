@@ -17,35 +17,55 @@
  *
  */
 
-#include <iomanip.hpp>
+#include <lexical_cast.hpp>
+#include <string-utils.hpp>
+
+#include <proc/file.hpp>
 #include <proc/net_wireless.hpp>
 
 namespace ifshow { namespace proc {
 
-    std::tuple<double, double, double, double>
-    get_wireless(const std::string &wlan)
+    std::map<ifname, std::tuple<double, double, double, double>>
+    get_wireless()
     {
-        std::ifstream proc_net_wireless(proc::NET_WIRELESS);
+        std::map<ifname, std::tuple<double, double, double, double>> ret;
+
+        // missing without wireless extensions
+        //
+        auto buf = try_read_file(proc::NET_WIRELESS);
+        if (!buf)
+            return ret;
+
+        more::tokenizer lines(*buf, "\n");
+        std::string_view line;
 
         /* skip 2 lines */
-        proc_net_wireless >> more::ignore_line >> more::ignore_line;
+        lines.next(line);
+        lines.next(line);
 
-        more::string_token if_name(":");
-        while (proc_net_wireless >> if_name) {
+        while (lines.next(line)) {
 
-            std::string name = more::trim_copy(if_name.str());
-            if (name != wlan) {
-                proc_net_wireless >> more::ignore_line;
-               continue;
-            }
+            auto colon = line.find(':');
+            if (colon == std::string_view::npos)
+                continue;
 
-            double status, link, level, noise;
-            proc_net_wireless >> status >> link >> level >> noise;
+            // status, link, level and noise ("0000   54.  -56.  -256")
+            //
+            double values[4] = { 0, 0, 0, 0 };
+            size_t n = 0;
+            for(auto v : more::tokens(line.substr(colon + 1), " "))
+            {
+                if (v.empty())
+                    continue;
+                if (n == 4)
+                    break;
+                values[n++] = more::try_lexical_cast<double>(v).value_or(0);
+            }
 
-            return std::make_tuple(status,link,level,noise);
+            ret.emplace(more::trim_view(line.substr(0, colon)), std::make_tuple(values[0], values[1], values[2], values[3]));
         }
 
-        return std::make_tuple(0.0,0.0,0.0,0.0);
+        return ret;
     }
 
 } // namespace proc
@@ -24,14 +24,20 @@
 #include <sstream>
 #include <string>
 #include <list>
+#include <map>
 
 #include <string-utils.hpp>
 #include <proc/files.hpp>
 
+#include <ifname.hpp>
+
 namespace ifshow { namespace proc {
 
-    extern std::tuple<double, double, double, double>
-    get_wireless(const std::string &);
+    // status, link, level and noise of the interfaces with wireless
+    // extensions, the only ones listed in /proc/net/wireless
+    //
+    extern std::map<ifname, std::tuple<double, double, double, double>>
+    get_wireless();
 
 } // namespace proc
 } // namespace ifshow
@@ -0,0 +1,104 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#include <stdexcept>
+#include <string>
+
+#include <proc/file.hpp>
+#include <proc/softnet.hpp>
+
+namespace ifshow { namespace proc {
+
+    static const size_t field_width = 9;   // "%08x "
+
+    static inline int
+    hex_digit(char c)
+    {
+        if (c >= '0' && c <= '9')
+            return c - '0';
+        if (c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+        return -1;
+    }
+
+
+    // 8 hex digits, no separators and no sign
+    //
+    static inline uint32_t
+    hex8(const char *p)
+    {
+        uint32_t ret = 0;
+        for(int i = 0; i < 8; i++)
+        {
+            int d = hex_digit(p[i]);
+            if (d < 0)
+                throw std::runtime_error(std::string(SOFTNET_STAT) + ": bad hex field");
+            ret = (ret << 4) | static_cast<uint32_t>(d);
+        }
+        return ret;
+    }
+
+
+    std::vector<softnet>
+    parse_softnet_stat(const char *buf, size_t len)
+    {
+        std::vector<softnet> ret;
+
+        const char *p = buf, *end = buf + len;
+
+        while (p < end)
+        {
+            // the fields of a line: 11 on old kernels, 13 since the backlog
+            // length and the CPU id were added
+            //
+            size_t fields = 0;
+            while (p + fields * field_width + 8 < end && p[fields * field_width + 8] == ' ')
+                fields++;
+            if (p + fields * field_width + 8 >= end || p[fields * field_width + 8] != '\n')
+                throw std::runtime_error(std::string(SOFTNET_STAT) + ": unexpected format");
+            fields++;
+
+            if (fields < 11)
+                throw std::runtime_error(std::string(SOFTNET_STAT) + ": too few fields");
+
+            softnet s;
+            s.processed    = hex8(p);
+            s.dropped      = hex8(p + 1 * field_width);
+            s.time_squeeze = hex8(p + 2 * field_width);
+            s.received_rps = hex8(p + 9 * field_width);
+            s.flow_limit   = hex8(p + 10 * field_width);
+            s.cpu          = fields >= 13 ? static_cast<int>(hex8(p + 12 * field_width)) : static_cast<int>(ret.size());
+
+            ret.push_back(s);
+            p += fields * field_width;
+        }
+
+        return ret;
+    }
+
+
+    std::vector<softnet>
+    get_softnet_stat()
+    {
+        auto buf = read_file(SOFTNET_STAT);
+        return parse_softnet_stat(buf.data(), buf.size());
+    }
+
+} // namespace proc
+} // namespace ifshow
+
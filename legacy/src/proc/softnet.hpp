@@ -0,0 +1,51 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <proc/files.hpp>
+
+namespace ifshow { namespace proc {
+
+    // a line of /proc/net/softnet_stat: the per-CPU backlog counters
+    // (32-bit, they wrap)
+    //
+    struct softnet
+    {
+        int         cpu;            // the CPU id (the line number on kernels < 5.10)
+        uint32_t    processed;      // packets taken from the backlog
+        uint32_t    dropped;        // backlog full
+        uint32_t    time_squeeze;   // net_rx_action out of budget or time
+        uint32_t    received_rps;   // IPIs to process an RPS backlog
+        uint32_t    flow_limit;     // dropped by the flow limit
+    };
+
+    // parse /proc/net/softnet_stat: every field is 8 hex digits followed by
+    // a blank, so the fields are at fixed offsets
+    //
+    extern std::vector<softnet> get_softnet_stat();
+
+    extern std::vector<softnet> parse_softnet_stat(const char *buf, size_t len);
+
+} // namespace proc
+} // namespace ifshow
+
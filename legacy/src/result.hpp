@@ -0,0 +1,117 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <cerrno>
+#include <cstring>
+#include <optional>
+#include <system_error>
+#include <utility>
+
+namespace ifshow {
+
+    // the errno of a failed collector
+    //
+    struct failure
+    {
+        int value;
+    };
+
+    inline failure
+    fail(int err)
+    {
+        return failure{ err };
+    }
+
+    /*
+     * result<T> holds either a value or the errno of the failure, so that
+     * probes that routinely fail (ethtool and wireless ioctls on virtual
+     * interfaces) don't need to throw. value() throws std::system_error
+     * for the callers that prefer exceptions.
+     */
+
+    template <typename T>
+    class result
+    {
+    public:
+        result(T value)
+        : m_value(std::move(value))
+        , m_error(0)
+        {}
+
+        result(failure f)
+        : m_value()
+        , m_error(f.value)
+        {}
+
+        explicit operator bool() const
+        {
+            return m_error == 0;
+        }
+
+        int
+        error() const
+        {
+            return m_error;
+        }
+
+        // the operation is not implemented by the driver
+        //
+        bool
+        unsupported() const
+        {
+            return m_error == EOPNOTSUPP || m_error == ENOTTY;
+        }
+
+        const char *
+        what() const
+        {
+            return strerror(m_error);
+        }
+
+        const T &
+        value() const
+        {
+            if (m_error)
+                throw std::system_error(m_error, std::generic_category());
+            return *m_value;
+        }
+
+        T &
+        value()
+        {
+            if (m_error)
+                throw std::system_error(m_error, std::generic_category());
+            return *m_value;
+        }
+
+        const T & operator*() const  { return *m_value; }
+        T & operator*()              { return *m_value; }
+
+        const T * operator->() const { return &*m_value; }
+        T * operator->()             { return &*m_value; }
+
+    private:
+        std::optional<T> m_value;
+        int m_error;
+    };
+
+} // namespace ifshow
+
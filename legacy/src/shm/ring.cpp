@@ -0,0 +1,260 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <net/if.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+
+#include <shm/ring.hpp>
+
+namespace ifshow { namespace shm {
+
+    static size_t
+    align64(size_t n)
+    {
+        return (n + 63) & ~size_t(63);
+    }
+
+    static size_t
+    names_offset()
+    {
+        return align64(sizeof(header));
+    }
+
+    static size_t
+    slots_offset(size_t interfaces)
+    {
+        return names_offset() + align64(interfaces * IFNAMSIZ);
+    }
+
+
+    // the header of a segment that may be corrupt or foreign: the sizes are
+    // computed in 64 bits, checking every step for overflow
+    //
+    static bool
+    valid_header(const header &h, size_t size)
+    {
+        if (h.magic != MAGIC || h.version != VERSION || h.slots < 2 || h.slot_size % alignof(slot))
+            return false;
+
+        uint64_t values, slot_min, slots, end;
+
+        if (__builtin_mul_overflow(uint64_t(h.interfaces), uint64_t(h.counters), &values) ||
+            __builtin_mul_overflow(values, uint64_t(sizeof(uint64_t)), &values) ||
+            __builtin_add_overflow(values, uint64_t(sizeof(slot)), &slot_min) ||
+            slot_min > h.slot_size)
+            return false;
+
+        if (__builtin_mul_overflow(uint64_t(h.interfaces), uint64_t(IFNAMSIZ), &end) || end > size)
+            return false;
+
+        if (__builtin_mul_overflow(uint64_t(h.slots), h.slot_size, &slots) ||
+            __builtin_add_overflow(uint64_t(slots_offset(h.interfaces)), slots, &end))
+            return false;
+
+        return end <= size;
+    }
+
+
+    writer::writer(const std::string &name, const std::vector<ifname> &ifs, uint32_t counters,
+                   uint32_t slots, uint64_t interval_ns)
+    : m_name(name)
+    , m_size(0)
+    , m_header(nullptr)
+    {
+        if (slots < 2)
+            throw std::invalid_argument("shm ring: at least 2 slots required");
+
+        size_t slot_size = align64(sizeof(slot) + ifs.size() * counters * sizeof(uint64_t));
+
+        m_size = slots_offset(ifs.size()) + slots * slot_size;
+
+        // replace any stale ring, readers still mapping it keep the old one
+        //
+        shm_unlink(name.c_str());
+
+        int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+        if (fd == -1)
+            throw std::system_error(errno, std::generic_category(), "shm_open");
+
+        if (ftruncate(fd, static_cast<off_t>(m_size)) == -1) {
+            int e = errno;
+            close(fd);
+            shm_unlink(name.c_str());
+            throw std::system_error(e, std::generic_category(), "ftruncate");
+        }
+
+        void *addr = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        int e = errno;
+        close(fd);
+
+        if (addr == MAP_FAILED) {
+            shm_unlink(name.c_str());
+            throw std::system_error(e, std::generic_category(), "mmap");
+        }
+
+        m_header = new (addr) header;
+        m_header->version     = VERSION;
+        m_header->slots       = slots;
+        m_header->interfaces  = static_cast<uint32_t>(ifs.size());
+        m_header->counters    = counters;
+        m_header->slot_size   = slot_size;
+        m_header->interval_ns = interval_ns;
+        m_header->head.store(0, std::memory_order_relaxed);
+
+        char *names = static_cast<char *>(addr) + names_offset();
+        for(size_t i = 0; i < ifs.size(); i++)
+            memcpy(names + i * IFNAMSIZ, ifs[i].c_str(), IFNAMSIZ);
+
+        for(uint32_t n = 0; n < slots; n++)
+            new (slot_at(n)) slot{};
+
+        // the magic is written last: a reader never sees a half-built ring
+        //
+        std::atomic_thread_fence(std::memory_order_release);
+        m_header->magic = MAGIC;
+    }
+
+
+    writer::~writer()
+    {
+        munmap(m_header, m_size);
+        shm_unlink(m_name.c_str());
+    }
+
+
+    slot *
+    writer::slot_at(uint64_t n) const
+    {
+        auto base = reinterpret_cast<char *>(m_header) + slots_offset(m_header->interfaces);
+        return reinterpret_cast<slot *>(base + (n % m_header->slots) * m_header->slot_size);
+    }
+
+
+    void
+    writer::timestamp(slot *s)
+    {
+        struct timespec mono, real;
+        clock_gettime(CLOCK_MONOTONIC, &mono);
+        clock_gettime(CLOCK_REALTIME, &real);
+
+        s->mono_ns = uint64_t(mono.tv_sec) * 1000000000 + uint64_t(mono.tv_nsec);
+        s->real_ns = uint64_t(real.tv_sec) * 1000000000 + uint64_t(real.tv_nsec);
+    }
+
+
+    reader::reader(const std::string &name)
+    : m_size(0)
+    , m_header(nullptr)
+    , m_names()
+    {
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd == -1)
+            throw std::system_error(errno, std::generic_category(), "shm_open " + name + " (is ifshowd running?)");
+
+        struct stat st;
+        if (fstat(fd, &st) == -1 || static_cast<size_t>(st.st_size) < sizeof(header)) {
+            close(fd);
+            throw std::runtime_error("shm ring: bad size");
+        }
+
+        m_size = static_cast<size_t>(st.st_size);
+
+        void *addr = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+        int e = errno;
+        close(fd);
+
+        if (addr == MAP_FAILED)
+            throw std::system_error(e, std::generic_category(), "mmap");
+
+        m_header = static_cast<const header *>(addr);
+
+        if (!valid_header(*m_header, m_size))
+        {
+            munmap(addr, m_size);
+            throw std::runtime_error("shm ring: bad header");
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        auto names = static_cast<const char *>(addr) + names_offset();
+        for(uint32_t i = 0; i < m_header->interfaces; i++)
+            m_names.emplace_back(std::string_view(names + i * IFNAMSIZ, strnlen(names + i * IFNAMSIZ, IFNAMSIZ - 1)));
+    }
+
+
+    reader::~reader()
+    {
+        munmap(const_cast<header *>(m_header), m_size);
+    }
+
+
+    const slot *
+    reader::slot_at(uint64_t n) const
+    {
+        auto base = reinterpret_cast<const char *>(m_header) + slots_offset(m_header->interfaces);
+        return reinterpret_cast<const slot *>(base + (n % m_header->slots) * m_header->slot_size);
+    }
+
+
+    bool
+    reader::read(uint64_t n, uint64_t *out, uint64_t &mono_ns) const
+    {
+        const slot *s = slot_at(n);
+
+        uint64_t seq = s->seq.load(std::memory_order_acquire);
+        if (seq != 2 * n + 2)
+            return false;
+
+        memcpy(out, s + 1, size() * sizeof(uint64_t));
+        mono_ns = s->mono_ns;
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        return s->seq.load(std::memory_order_relaxed) == seq;
+    }
+
+
+    uint64_t
+    reader::latest(uint64_t *out, uint64_t &mono_ns) const
+    {
+        // retry while the writer laps the reader (very unlikely)
+        //
+        for(;;)
+        {
+            uint64_t h = head();
+            if (h == 0)
+                return 0;
+
+            if (read(h - 1, out, mono_ns))
+                return h;
+        }
+    }
+
+} // namespace shm
+} // namespace ifshow
+
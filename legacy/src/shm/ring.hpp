@@ -0,0 +1,183 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <ifname.hpp>
+
+namespace ifshow { namespace shm {
+
+    static const char DEFAULT_NAME [] = "/ifshow";
+
+    /*
+     * A POSIX shared memory ring of counter snapshots, published by ifshowd
+     * and read lock-free by any number of readers.
+     *
+     * layout: header | interface names (IFNAMSIZ each) | slot[0] ... slot[n-1]
+     *
+     * Each slot is a seqlock: the writer of the snapshot n sets seq to 2n+1,
+     * fills the values and sets seq to 2n+2. A reader accepts the slot only
+     * if seq is 2n+2 both before and after copying the values, so it never
+     * returns a torn or a recycled snapshot.
+     */
+
+    static const uint64_t MAGIC   = 0x776f68736669ULL;     // "ifshow"
+    static const uint32_t VERSION = 1;
+
+    struct header
+    {
+        uint64_t                magic;
+        uint32_t                version;
+        uint32_t                slots;
+        uint32_t                interfaces;
+        uint32_t                counters;       // per interface
+        uint64_t                slot_size;      // in bytes, values included
+        uint64_t                interval_ns;    // sampling interval of the writer
+        std::atomic<uint64_t>   head;           // snapshots published so far
+    };
+
+    struct slot
+    {
+        std::atomic<uint64_t>   seq;
+        uint64_t                mono_ns;        // CLOCK_MONOTONIC
+        uint64_t                real_ns;        // CLOCK_REALTIME
+        uint64_t                reserved;
+
+        // followed by interfaces * counters values, row-major
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "shm ring requires lock-free 64-bit atomics");
+
+
+    class writer
+    {
+    public:
+        writer(const std::string &name, const std::vector<ifname> &ifs, uint32_t counters,
+               uint32_t slots, uint64_t interval_ns);
+
+        ~writer();
+
+        writer(const writer &) = delete;
+        writer& operator=(const writer &) = delete;
+
+        // fill(uint64_t *values) writes the next snapshot in place: it must
+        // not throw, or the slot is left odd and readers skip it forever
+        //
+        template <typename Fun>
+        void publish(Fun fill)
+        {
+            uint64_t n = m_header->head.load(std::memory_order_relaxed);
+            slot *s = slot_at(n);
+
+            s->seq.store(2 * n + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            fill(reinterpret_cast<uint64_t *>(s + 1));
+            timestamp(s);
+
+            s->seq.store(2 * n + 2, std::memory_order_release);
+            m_header->head.store(n + 1, std::memory_order_release);
+        }
+
+    private:
+        slot * slot_at(uint64_t n) const;
+        static void timestamp(slot *s);
+
+        std::string m_name;
+        size_t      m_size;
+        header *    m_header;
+    };
+
+
+    class reader
+    {
+    public:
+        explicit reader(const std::string &name);
+
+        ~reader();
+
+        reader(const reader &) = delete;
+        reader& operator=(const reader &) = delete;
+
+        const std::vector<ifname> &
+        names() const
+        {
+            return m_names;
+        }
+
+        size_t
+        interfaces() const
+        {
+            return m_names.size();
+        }
+
+        size_t
+        counters() const
+        {
+            return m_header->counters;
+        }
+
+        size_t
+        size() const
+        {
+            return interfaces() * counters();
+        }
+
+        size_t
+        slots() const
+        {
+            return m_header->slots;
+        }
+
+        uint64_t
+        interval_ns() const
+        {
+            return m_header->interval_ns;
+        }
+
+        uint64_t
+        head() const
+        {
+            return m_header->head.load(std::memory_order_acquire);
+        }
+
+        // copy the snapshot n into out[0..size()); false if it is not
+        // published yet or it was overwritten
+        //
+        bool read(uint64_t n, uint64_t *out, uint64_t &mono_ns) const;
+
+        // copy the latest snapshot n, return n + 1 (0 if none is published)
+        //
+        uint64_t latest(uint64_t *out, uint64_t &mono_ns) const;
+
+    private:
+        const slot * slot_at(uint64_t n) const;
+
+        size_t                      m_size;
+        const header *              m_header;
+        std::vector<ifname>         m_names;
+    };
+
+} // namespace shm
+} // namespace ifshow
+
@@ -0,0 +1,276 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#include <charconv>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <snapshot/snapshot.hpp>
+#include <watch/watch.hpp>
+
+#include <colors.hpp>
+
+namespace ifshow { namespace snapshot {
+
+    static uint64_t
+    to_u64(std::string_view s)
+    {
+        uint64_t ret = 0;
+        std::from_chars(s.data(), s.data() + s.size(), ret);
+        return ret;
+    }
+
+
+    // the difference of two sorted comma separated lists (-removed +added)
+    //
+    static std::string
+    list_diff(std::string_view a, std::string_view b)
+    {
+        auto next = [](std::string_view &s) {
+            auto c = s.find(',');
+            auto ret = s.substr(0, c);
+            s.remove_prefix(c == std::string_view::npos ? s.size() : c + 1);
+            return ret;
+        };
+
+        std::string ret;
+
+        auto x = next(a), y = next(b);
+        while (!x.empty() || !y.empty())
+        {
+            if (y.empty() || (!x.empty() && x < y)) {
+                ret.append(" -").append(x);
+                x = next(a);
+            }
+            else if (x.empty() || y < x) {
+                ret.append(" +").append(y);
+                y = next(b);
+            }
+            else {
+                x = next(a);
+                y = next(b);
+            }
+        }
+
+        return ret;
+    }
+
+
+    // the differing fields of two records (a single merge over the sorted
+    // keys): empty if none
+    //
+    static std::string
+    diff_fields(const record &a, const record &b, double secs)
+    {
+        std::ostringstream out;
+
+        auto i = a.fields.begin(), j = b.fields.begin();
+
+        while (i != a.fields.end() || j != b.fields.end())
+        {
+            std::string_view key, va, vb;
+
+            if (j == b.fields.end() || (i != a.fields.end() && i->first < j->first)) {
+                key = i->first; va = i->second; ++i;
+            }
+            else if (i == a.fields.end() || j->first < i->first) {
+                key = j->first; vb = j->second; ++j;
+            }
+            else {
+                key = i->first; va = i->second; vb = j->second; ++i; ++j;
+            }
+
+            // counters: missing is 0 (the driver counters are saved when
+            // non-zero only)
+            //
+            if (is_counter(key))
+            {
+                auto ca = to_u64(va), cb = to_u64(vb);
+                if (ca == cb)
+                    continue;
+
+                out << "  " << key << ' ';
+                if (cb > ca)
+                    out << '+' << (cb - ca);
+                else
+                    out << red() << '-' << (ca - cb) << reset();
+
+                if (cb > ca && secs > 0)
+                    out << " (" << watch::human((cb - ca) / secs) << "/s)";
+                out << '\n';
+                continue;
+            }
+
+            if (va == vb)
+                continue;
+
+            if (key == "features") {
+                out << "  features" << list_diff(va, vb) << '\n';
+                continue;
+            }
+
+            out << "  " << key << ' ' << (va.empty() ? "-" : va) << " -> " << bold() << (vb.empty() ? "-" : vb) << reset() << '\n';
+        }
+
+        return out.str();
+    }
+
+
+    struct summary
+    {
+        size_t same = 0, changed = 0, added = 0, removed = 0;
+    };
+
+
+    static void
+    diff_pair(const record &a, const record &b, const char *by, double secs, summary &sum)
+    {
+        auto fields = diff_fields(a, b, secs);
+
+        if (fields.empty() && a.name == b.name) {
+            sum.same++;
+            return;
+        }
+
+        sum.changed++;
+
+        std::cout << cyan() << b.name << reset();
+        if (a.name != b.name)
+            std::cout << " (was " << a.name << ", matched by " << by << ')';
+        std::cout << '\n' << fields;
+    }
+
+
+    // pair the interfaces left by the name pass by key (bus, ifindex), in
+    // linear time with a hash of b
+    //
+    static void
+    match_by(const char *key, std::vector<record> &a, std::vector<record> &b, double secs, summary &sum)
+    {
+        std::unordered_map<std::string_view, size_t> index;
+        for(size_t n = 0; n < b.size(); n++)
+        {
+            auto v = b[n].get(key);
+            if (!v.empty())
+                index.emplace(v, n);
+        }
+
+        std::vector<bool> used_b(b.size());
+        std::vector<record> left_a;
+
+        for(auto &r : a)
+        {
+            auto v = r.get(key);
+            auto it = v.empty() ? index.end() : index.find(v);
+
+            if (it == index.end() || used_b[it->second]) {
+                left_a.push_back(r);
+                continue;
+            }
+
+            used_b[it->second] = true;
+            diff_pair(r, b[it->second], key, secs, sum);
+        }
+
+        std::vector<record> left_b;
+        for(size_t n = 0; n < b.size(); n++)
+            if (!used_b[n])
+                left_b.push_back(b[n]);
+
+        a.clear();
+        b.clear();
+        for(auto &r : left_a)
+            a.push_back(r);
+        for(auto &r : left_b)
+            b.push_back(r);
+    }
+
+
+    int
+    diff_snapshots(const options &opts)
+    try
+    {
+        if (opts.files.size() != 2)
+            throw std::runtime_error("--diff requires two snapshot files");
+
+        reader ra(opts.files[0]), rb(opts.files[1]);
+
+        double secs = ra.time() > 0 && rb.time() > ra.time() ? rb.time() - ra.time() : 0;
+
+        std::cout << "--- " << opts.files[0] << " host:" << (ra.host().empty() ? "-" : ra.host()) << '\n'
+                  << "+++ " << opts.files[1] << " host:" << (rb.host().empty() ? "-" : rb.host());
+        if (secs > 0)
+            std::cout << " after " << secs << "s";
+        std::cout << '\n';
+
+        // both files are sorted by name: a single merge pass pairs the
+        // interfaces with the same name, only the others are kept
+        //
+        summary sum;
+        std::vector<record> only_a, only_b;
+
+        record a, b;
+        bool has_a = ra.next(a), has_b = rb.next(b);
+
+        while (has_a || has_b)
+        {
+            if (has_a && (!has_b || a.name < b.name)) {
+                only_a.push_back(a);
+                has_a = ra.next(a);
+            }
+            else if (has_b && (!has_a || b.name < a.name)) {
+                only_b.push_back(b);
+                has_b = rb.next(b);
+            }
+            else {
+                diff_pair(a, b, "name", secs, sum);
+                has_a = ra.next(a);
+                has_b = rb.next(b);
+            }
+        }
+
+        // renamed interfaces (another host, udev names): the same PCI
+        // function, or the same ifindex
+        //
+        match_by("bus", only_a, only_b, secs, sum);
+        match_by("ifindex", only_a, only_b, secs, sum);
+
+        for(auto &r : only_a)
+            std::cout << red() << "- " << r.name << reset() << '\n';
+        for(auto &r : only_b)
+            std::cout << green() << "+ " << r.name << reset() << '\n';
+
+        sum.removed = only_a.size();
+        sum.added = only_b.size();
+
+        std::cout << sum.changed << " changed, " << sum.same << " unchanged, "
+                  << sum.added << " added, " << sum.removed << " removed" << std::endl;
+
+        return 0;
+    }
+    catch(std::exception &e)
+    {
+        std::cerr << "ifshow: " << e.what() << std::endl;
+        return 1;
+    }
+
+} // namespace snapshot
+} // namespace ifshow
+
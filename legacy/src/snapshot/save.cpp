@@ -0,0 +1,64 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include <snapshot/snapshot.hpp>
+#include <watch/watch.hpp>
+
+namespace ifshow { namespace snapshot {
+
+    int
+    save_snapshot(const options &opts)
+    try
+    {
+        auto ifs = watch::select_interfaces(opts);
+        if (ifs.empty())
+            throw std::runtime_error("no interface to save");
+
+        if (opts.snapshot == "-") {
+            write(std::cout, ifs);
+            return 0;
+        }
+
+        std::ofstream out(opts.snapshot);
+        if (!out)
+            throw std::runtime_error(opts.snapshot + ": " + strerror(errno));
+
+        write(out, ifs);
+
+        out.close();
+        if (!out)
+            throw std::runtime_error(opts.snapshot + ": write error");
+
+        return 0;
+    }
+    catch(std::exception &e)
+    {
+        std::cerr << "ifshow: " << e.what() << std::endl;
+        return 1;
+    }
+
+} // namespace snapshot
+} // namespace ifshow
+
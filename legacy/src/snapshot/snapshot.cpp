@@ -0,0 +1,416 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <ethtool/features.hpp>
+#include <ethtool/stats.hpp>
+#include <ethtool/tuning.hpp>
+#include <netlink/link.hpp>
+#include <proc/interrupt.hpp>
+#include <snapshot/snapshot.hpp>
+
+#include <ifr.hpp>
+
+namespace ifshow { namespace snapshot {
+
+    void
+    record::parse()
+    {
+        fields.clear();
+
+        std::string_view s(line);
+
+        auto tab = s.find('\t');
+        name = s.substr(0, tab);
+
+        while (tab != std::string_view::npos)
+        {
+            s.remove_prefix(tab + 1);
+            tab = s.find('\t');
+
+            auto field = s.substr(0, tab);
+            auto eq = field.find('=');
+            if (eq == std::string_view::npos)
+                continue;
+
+            fields.emplace_back(field.substr(0, eq), field.substr(eq + 1));
+        }
+    }
+
+
+    std::string_view
+    record::get(std::string_view key) const
+    {
+        auto it = std::lower_bound(fields.begin(), fields.end(), key, [](const std::pair<std::string_view, std::string_view> &f, std::string_view k) {
+                                    return f.first < k;
+                                  });
+        return it != fields.end() && it->first == key ? it->second : std::string_view();
+    }
+
+
+    reader::reader(const std::string &path)
+    : m_path(path)
+    , m_in(path)
+    , m_host()
+    , m_time(0)
+    , m_last()
+    , m_lineno(1)
+    {
+        if (!m_in)
+            throw std::runtime_error(path + ": " + strerror(errno));
+
+        record header;
+        if (!std::getline(m_in, header.line) || header.line.compare(0, sizeof(MAGIC) - 1, MAGIC) != 0)
+            throw std::runtime_error(path + ": not an ifshow snapshot");
+
+        // the header has no name: the first field is the magic
+        //
+        header.parse();
+        std::sort(header.fields.begin(), header.fields.end());
+
+        m_host = std::string(header.get("host"));
+        auto t = header.get("time");
+        m_time = t.empty() ? 0 : strtod(std::string(t).c_str(), nullptr);
+    }
+
+
+    bool
+    reader::next(record &r)
+    {
+        while (std::getline(m_in, r.line))
+        {
+            m_lineno++;
+
+            if (r.line.empty() || r.line[0] == '#')
+                continue;
+
+            r.parse();
+
+            if (!m_last.empty() && !(m_last < r.name))
+                throw std::runtime_error(m_path + ':' + std::to_string(m_lineno) + ": interfaces not sorted by name");
+
+            m_last = std::string(r.name);
+            return true;
+        }
+
+        return false;
+    }
+
+
+    static const struct
+    {
+        const char *name;
+        __u64 rtnl_link_stats64::*field;
+    }
+    link_counters[] =
+    {
+        { "stat.rx_packets",        &rtnl_link_stats64::rx_packets          },
+        { "stat.tx_packets",        &rtnl_link_stats64::tx_packets          },
+        { "stat.rx_bytes",          &rtnl_link_stats64::rx_bytes            },
+        { "stat.tx_bytes",          &rtnl_link_stats64::tx_bytes            },
+        { "stat.rx_errors",         &rtnl_link_stats64::rx_errors           },
+        { "stat.tx_errors",         &rtnl_link_stats64::tx_errors           },
+        { "stat.rx_dropped",        &rtnl_link_stats64::rx_dropped          },
+        { "stat.tx_dropped",        &rtnl_link_stats64::tx_dropped          },
+        { "stat.multicast",         &rtnl_link_stats64::multicast           },
+        { "stat.collisions",        &rtnl_link_stats64::collisions          },
+        { "stat.rx_length_errors",  &rtnl_link_stats64::rx_length_errors    },
+        { "stat.rx_over_errors",    &rtnl_link_stats64::rx_over_errors      },
+        { "stat.rx_crc_errors",     &rtnl_link_stats64::rx_crc_errors       },
+        { "stat.rx_frame_errors",   &rtnl_link_stats64::rx_frame_errors     },
+        { "stat.rx_fifo_errors",    &rtnl_link_stats64::rx_fifo_errors      },
+        { "stat.rx_missed_errors",  &rtnl_link_stats64::rx_missed_errors    },
+        { "stat.tx_aborted_errors", &rtnl_link_stats64::tx_aborted_errors   },
+        { "stat.tx_carrier_errors", &rtnl_link_stats64::tx_carrier_errors   },
+        { "stat.tx_fifo_errors",    &rtnl_link_stats64::tx_fifo_errors      },
+        { "stat.rx_nohandler",      &rtnl_link_stats64::rx_nohandler        },
+    };
+
+
+    // keys and values can't contain the separators
+    //
+    static std::string
+    sanitize(std::string s, bool key)
+    {
+        for(auto &c : s)
+            if (c == '\t' || c == '\n' || (key && (c == '=' || c == ' ')))
+                c = key ? '_' : ' ';
+
+        while (!s.empty() && s.back() == ' ')
+            s.pop_back();
+        return s;
+    }
+
+
+    typedef std::vector<libifshow::field> fields;
+
+    static void
+    add(fields &f, const std::string &key, const std::string &value)
+    {
+        f.push_back(libifshow::field{ sanitize(key, true), sanitize(value, false) });
+    }
+
+
+    // sorted by key, the first one of the duplicates kept (so that the
+    // diff is a merge)
+    //
+    static void
+    sort_fields(fields &f)
+    {
+        std::stable_sort(f.begin(), f.end(), [](const libifshow::field &a, const libifshow::field &b) {
+                            return a.key < b.key;
+                         });
+
+        f.erase(std::unique(f.begin(), f.end(), [](const libifshow::field &a, const libifshow::field &b) {
+                    return a.key == b.key;
+                }), f.end());
+    }
+
+
+    static void
+    add_link_counters(fields &f, const netlink::link &l)
+    {
+        if (l.has_stats)
+            for(auto &c : link_counters)
+                add(f, c.name, std::to_string(l.stats.*c.field));
+    }
+
+
+    static void
+    add_ethtool_counters(fields &f, const ifr &iif, const ethtool_drvinfo &info)
+    {
+        if (!info.n_stats)
+            return;
+
+        try
+        {
+            auto layout = ethtool::get_stats_layout(iif, info);
+            auto values = ethtool::get_stats(iif, *layout);
+            for(size_t i = 0; i < layout->size(); i++)
+                if (values[i])
+                    add(f, "ethtool." + layout->name[i], std::to_string(values[i]));
+        }
+        catch(std::exception &)
+        {
+        }
+    }
+
+
+    static libifshow::interface
+    collect_interface(const ifname &name,
+                      const std::unordered_map<ifname, const netlink::link *> &links,
+                      const std::unordered_map<int, ifname> &index,
+                      const std::unordered_map<ifname, ethtool::tuning> &tuning,
+                      const std::unordered_map<ifname, ethtool::feature_set> &features,
+                      const std::vector<proc::interrupt> &table)
+    {
+        libifshow::interface ret;
+        ret.name = name.str();
+
+        fields &f = ret.fields;
+
+        ifr iif(name);
+
+        auto li = links.find(name);
+        if (li != links.end())
+        {
+            auto &l = *li->second;
+            add(f, "ifindex", std::to_string(l.index));
+            if (!l.kind.empty())
+                add(f, "kind", l.kind);
+            if (l.master) {
+                auto m = index.find(l.master);
+                add(f, "master", m != index.end() ? m->second.str() : std::to_string(l.master));
+            }
+            add_link_counters(f, l);
+        }
+
+        add(f, "flags", iif.flags_str());
+        try { add(f, "mtu", std::to_string(iif.mtu())); } catch(std::exception &) {}
+
+        if (auto mac = iif.try_mac())
+            add(f, "mac", *mac);
+        if (auto qlen = iif.try_txqueuelen())
+            add(f, "txqueuelen", std::to_string(*qlen));
+
+        auto info = iif.try_ethtool_info();
+        if (info)
+        {
+            add(f, "driver", info->driver);
+            add(f, "driver_version", info->version);
+            if (strlen(info->fw_version))
+                add(f, "firmware", info->fw_version);
+            // virtual devices report N/A: it can't align interfaces
+            //
+            if (strlen(info->bus_info) && strcmp(info->bus_info, "N/A") != 0)
+                add(f, "bus", info->bus_info);
+
+            add_ethtool_counters(f, iif, *info);
+        }
+
+        auto ti = tuning.find(name);
+        if (ti != tuning.end())
+        {
+            auto &t = ti->second;
+            if (t.rings) {
+                add(f, "ring.rx", std::to_string(t.rings->rx_pending));
+                add(f, "ring.tx", std::to_string(t.rings->tx_pending));
+                add(f, "ring.rx_max", std::to_string(t.rings->rx_max_pending));
+                add(f, "ring.tx_max", std::to_string(t.rings->tx_max_pending));
+            }
+            if (t.channels) {
+                add(f, "channel.rx", std::to_string(t.channels->rx_count));
+                add(f, "channel.tx", std::to_string(t.channels->tx_count));
+                add(f, "channel.other", std::to_string(t.channels->other_count));
+                add(f, "channel.combined", std::to_string(t.channels->combined_count));
+            }
+            if (t.coalesce) {
+                add(f, "coalesce.adaptive_rx", t.coalesce->use_adaptive_rx_coalesce ? "on" : "off");
+                add(f, "coalesce.adaptive_tx", t.coalesce->use_adaptive_tx_coalesce ? "on" : "off");
+                add(f, "coalesce.rx_usecs", std::to_string(t.coalesce->rx_coalesce_usecs));
+                add(f, "coalesce.rx_frames", std::to_string(t.coalesce->rx_max_coalesced_frames));
+                add(f, "coalesce.tx_usecs", std::to_string(t.coalesce->tx_coalesce_usecs));
+                add(f, "coalesce.tx_frames", std::to_string(t.coalesce->tx_max_coalesced_frames));
+            }
+        }
+
+        // the active features, by name (sorted, so that the diff is a merge)
+        //
+        auto fi = features.find(name);
+        if (fi != features.end())
+        {
+            auto &names = ethtool::feature_names();
+
+            std::vector<std::string> on;
+            for(size_t bit = 0; bit < names.size(); bit++)
+                if (ethtool::feature_set::test(fi->second.active, bit))
+                    on.push_back(names[bit]);
+
+            std::sort(on.begin(), on.end());
+
+            std::string list;
+            for(auto &n : on)
+                list += (list.empty() ? "" : ",") + n;
+            add(f, "features", list);
+        }
+
+        for(auto irq : proc::get_interface_irqs(name.str(), table))
+        {
+            auto aff = proc::get_irq_affinity(irq);
+            if (!aff.empty())
+                add(f, "irq." + std::to_string(irq), aff);
+        }
+
+        sort_fields(f);
+        return ret;
+    }
+
+
+    static double
+    now()
+    {
+        return std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+
+    libifshow::snapshot
+    collect(const std::vector<ifname> &ifnames)
+    {
+        auto links = netlink::get_links();
+
+        std::unordered_map<ifname, const netlink::link *> by_name;
+        std::unordered_map<int, ifname> index;
+        for(auto &l : links) {
+            by_name.emplace(l.name, &l);
+            index.emplace(l.index, l.name);
+        }
+
+        auto tuning   = ethtool::get_tuning(ifnames);
+        auto features = ethtool::get_features(ifnames);
+        auto table    = proc::get_interrupts();
+
+        char host[256] = {};
+        gethostname(host, sizeof(host) - 1);
+
+        libifshow::snapshot ret;
+        ret.host = sanitize(host, false);
+        ret.time = now();
+        ret.generation = 0;
+
+        auto names = ifnames;
+        std::sort(names.begin(), names.end());
+
+        ret.interfaces.reserve(names.size());
+        for(auto &name : names)
+            ret.interfaces.push_back(collect_interface(name, by_name, index, tuning, features, table));
+
+        return ret;
+    }
+
+
+    void
+    refresh_counters(libifshow::interface &i, const netlink::link &l)
+    {
+        auto &f = i.fields;
+
+        f.erase(std::remove_if(f.begin(), f.end(), [](const libifshow::field &x) { return is_counter(x.key); }), f.end());
+
+        add_link_counters(f, l);
+
+        ifr iif(l.name);
+        if (auto info = iif.try_ethtool_info())
+            add_ethtool_counters(f, iif, *info);
+
+        sort_fields(f);
+    }
+
+
+    void
+    write(std::ostream &out, const libifshow::snapshot &snap)
+    {
+        out << MAGIC << "\thost=" << snap.host << "\ttime=" << std::fixed << std::setprecision(3) << snap.time << '\n';
+        out << std::defaultfloat;
+
+        for(auto &i : snap.interfaces)
+        {
+            out << i.name;
+            for(auto &f : i.fields)
+                out << '\t' << f.key << '=' << f.value;
+            out << '\n';
+        }
+    }
+
+
+    void
+    write(std::ostream &out, const std::vector<ifname> &ifnames)
+    {
+        write(out, collect(ifnames));
+    }
+
+} // namespace snapshot
+} // namespace ifshow
+
@@ -0,0 +1,140 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <libifshow.hpp>
+#include <netlink/link.hpp>
+
+#include <ifname.hpp>
+#include <options.hpp>
+
+namespace ifshow { namespace snapshot {
+
+    /*
+     * A snapshot is a text file: a header line followed by one line per
+     * interface, sorted by name:
+     *
+     *  # ifshow-snapshot 1<TAB>host=HOST<TAB>time=SECS
+     *  NAME<TAB>KEY=VALUE<TAB>KEY=VALUE...
+     *
+     * The keys of a line are sorted too, so that two snapshots (and two
+     * interfaces) are compared with a single merge pass. Counters are the
+     * stat.* (rtnl_link_stats64) and ethtool.* (driver, non-zero only) keys.
+     */
+
+    static const char MAGIC []= "# ifshow-snapshot 1";
+
+    struct record
+    {
+        std::string line;
+        std::string_view name;
+        std::vector<std::pair<std::string_view, std::string_view>> fields;
+
+        record() = default;
+
+        // the views point into line: copies parse it again
+        //
+        record(const record &other)
+        : line(other.line)
+        {
+            parse();
+        }
+
+        record& operator=(const record &) = delete;
+
+        void parse();
+
+        // the value of key, empty if not present
+        //
+        std::string_view get(std::string_view key) const;
+    };
+
+    // a counter key (the diff displays the delta)
+    //
+    inline bool
+    is_counter(std::string_view key)
+    {
+        return key.compare(0, 5, "stat.") == 0 || key.compare(0, 8, "ethtool.") == 0;
+    }
+
+    // read a snapshot one interface at a time
+    //
+    class reader
+    {
+    public:
+        explicit reader(const std::string &path);
+
+        const std::string &
+        host() const
+        {
+            return m_host;
+        }
+
+        // seconds since the epoch, 0 if unknown
+        //
+        double
+        time() const
+        {
+            return m_time;
+        }
+
+        // the next record, in name order: throws if the file is not sorted
+        //
+        bool next(record &r);
+
+    private:
+        std::string     m_path;
+        std::ifstream   m_in;
+        std::string     m_host;
+        double          m_time;
+        std::string     m_last;
+        size_t          m_lineno;
+    };
+
+    // probe the interfaces (what the file of a snapshot holds)
+    //
+    extern libifshow::snapshot collect(const std::vector<ifname> &ifnames);
+
+    // re-read only the counters (stat.* and ethtool.*) of an interface
+    //
+    extern void refresh_counters(libifshow::interface &i, const netlink::link &l);
+
+    extern void write(std::ostream &out, const libifshow::snapshot &snap);
+
+    // write the snapshot of the interfaces
+    //
+    extern void write(std::ostream &out, const std::vector<ifname> &ifnames);
+
+    // ifshow --snapshot FILE: save the selected interfaces
+    //
+    extern int save_snapshot(const options &opts);
+
+    // ifshow --diff A B: the properties that differ and the counter deltas
+    //
+    extern int diff_snapshots(const options &opts);
+
+} // namespace snapshot
+} // namespace ifshow
+
@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <system_error>
+
+#include <sysfs/batch.hpp>
+
+namespace ifshow { namespace sysfs {
+
+    batch_reader::batch_reader(const char *dir)
+    : m_dirfd(::open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC))
+    , m_buffer(4096)
+    {
+        if (m_dirfd == -1)
+            throw std::system_error(errno, std::generic_category(), dir);
+    }
+
+
+    batch_reader::~batch_reader()
+    {
+        ::close(m_dirfd);
+    }
+
+
+    std::string_view
+    batch_reader::read(const char *path)
+    {
+        int fd = ::openat(m_dirfd, path, O_RDONLY | O_CLOEXEC);
+        if (fd == -1)
+            return std::string_view();
+
+        // sysfs attributes are at most a page
+        //
+        ssize_t n = ::read(fd, m_buffer.data(), m_buffer.size());
+        ::close(fd);
+
+        if (n <= 0)
+            return std::string_view();
+
+        while (n > 0 && (m_buffer[n - 1] == '\n' || m_buffer[n - 1] == ' '))
+            n--;
+
+        return std::string_view(m_buffer.data(), static_cast<size_t>(n));
+    }
+
+
+    std::vector<std::string>
+    batch_reader::list(const std::string &path) const
+    {
+        std::vector<std::string> ret;
+
+        int fd = ::openat(m_dirfd, path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd == -1)
+            return ret;
+
+        DIR *d = fdopendir(fd);
+        if (!d) {
+            ::close(fd);
+            return ret;
+        }
+
+        while (auto e = readdir(d))
+        {
+            if (e->d_name[0] == '.' && (e->d_name[1] == '\0' || (e->d_name[1] == '.' && e->d_name[2] == '\0')))
+                continue;
+            ret.emplace_back(e->d_name);
+        }
+
+        closedir(d);
+        return ret;
+    }
+
+} // namespace sysfs
+} // namespace ifshow
+
@@ -0,0 +1,67 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sysfs/files.hpp>
+
+namespace ifshow { namespace sysfs {
+
+    /*
+     * batch_reader reads many small sysfs attributes below a directory
+     * (e.g. the queues of all the interfaces): the directory fd is opened
+     * once and every file is opened with openat() relative to it, and read
+     * into a single reusable buffer. No allocation per file.
+     */
+
+    class batch_reader
+    {
+    public:
+        explicit batch_reader(const char *dir = CLASS_NET);
+        ~batch_reader();
+
+        batch_reader(const batch_reader &) = delete;
+        batch_reader& operator=(const batch_reader &) = delete;
+
+        // the content of dir/path without the trailing newline, empty if it
+        // can't be read; valid until the next call
+        //
+        std::string_view read(const char *path);
+
+        std::string_view
+        read(const std::string &path)
+        {
+            return read(path.c_str());
+        }
+
+        // the entries of dir/path (no . and ..)
+        //
+        std::vector<std::string> list(const std::string &path) const;
+
+    private:
+        int                 m_dirfd;
+        std::vector<char>   m_buffer;
+    };
+
+} // namespace sysfs
+} // namespace ifshow
+
@@ -0,0 +1,68 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#include <dirent.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+
+#include <sysfs/irq.hpp>
+
+namespace ifshow { namespace sysfs {
+
+    static bool
+    list_msi_irqs(const std::string &dir, std::vector<int> &out)
+    {
+        DIR *d = opendir((dir + "/msi_irqs").c_str());
+        if (!d)
+            return false;
+
+        while (auto e = readdir(d))
+        {
+            if (e->d_name[0] >= '0' && e->d_name[0] <= '9')
+                out.push_back(atoi(e->d_name));
+        }
+
+        closedir(d);
+        return true;
+    }
+
+
+    std::vector<int>
+    get_device_irqs(const std::string &ifname)
+    {
+        std::vector<int> ret;
+
+        std::string dev = std::string(CLASS_NET) + '/' + ifname + "/device";
+
+        if (!list_msi_irqs(dev, ret) && !list_msi_irqs(dev + "/..", ret))
+        {
+            std::ifstream in(dev + "/irq");
+            int irq = 0;
+            if (in >> irq && irq > 0)
+                ret.push_back(irq);
+        }
+
+        std::sort(ret.begin(), ret.end());
+        return ret;
+    }
+
+} // namespace sysfs
+} // namespace ifshow
+
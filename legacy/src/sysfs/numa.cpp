@@ -0,0 +1,199 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#include <dirent.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+
+#include <sysfs/numa.hpp>
+
+namespace ifshow { namespace sysfs {
+
+    std::string
+    read_line(const std::string &path)
+    {
+        std::ifstream in(path);
+        std::string ret;
+        std::getline(in, ret);
+        return ret;
+    }
+
+
+    std::vector<int>
+    parse_cpulist(const std::string &list)
+    {
+        std::vector<int> ret;
+
+        const char *p = list.c_str();
+        while (*p)
+        {
+            char *end;
+            long a = strtol(p, &end, 10);
+            if (end == p)
+                break;
+
+            long b = a;
+            if (*end == '-')
+                b = strtol(end + 1, &end, 10);
+
+            for(long c = a; c <= b; c++)
+                ret.push_back(static_cast<int>(c));
+
+            p = *end == ',' ? end + 1 : end;
+        }
+
+        return ret;
+    }
+
+
+    std::string
+    format_cpulist(const std::vector<int> &cpus)
+    {
+        std::string ret;
+
+        for(size_t i = 0; i < cpus.size(); )
+        {
+            size_t j = i;
+            while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1)
+                j++;
+
+            if (!ret.empty())
+                ret += ',';
+            ret += std::to_string(cpus[i]);
+            if (j > i)
+                ret += '-' + std::to_string(cpus[j]);
+
+            i = j + 1;
+        }
+
+        return ret;
+    }
+
+
+    std::vector<int>
+    parse_cpumask(const std::string &mask)
+    {
+        std::vector<int> ret;
+
+        // the rightmost hex digit holds the CPUs 0-3
+        //
+        int base = 0;
+        for(auto it = mask.rbegin(); it != mask.rend(); ++it)
+        {
+            int v;
+            if (*it >= '0' && *it <= '9')
+                v = *it - '0';
+            else if (*it >= 'a' && *it <= 'f')
+                v = *it - 'a' + 10;
+            else if (*it >= 'A' && *it <= 'F')
+                v = *it - 'A' + 10;
+            else
+                continue;
+
+            for(int b = 0; b < 4; b++)
+                if (v & (1 << b))
+                    ret.push_back(base + b);
+
+            base += 4;
+        }
+
+        std::sort(ret.begin(), ret.end());
+        return ret;
+    }
+
+
+    device_numa
+    get_device_numa(const std::string &ifname)
+    {
+        device_numa ret { -1, {} };
+
+        std::string dev = std::string(CLASS_NET) + '/' + ifname + "/device";
+
+        for(auto dir : { dev, dev + "/.." })
+        {
+            auto node = read_line(dir + "/numa_node");
+            auto local = read_line(dir + "/local_cpulist");
+
+            if (node.empty() && local.empty())
+                continue;
+
+            ret.node = node.empty() ? -1 : atoi(node.c_str());
+            ret.local_cpus = parse_cpulist(local);
+            break;
+        }
+
+        return ret;
+    }
+
+
+    std::vector<int>
+    get_cpu_nodes()
+    {
+        std::vector<int> ret;
+
+        for(auto node : parse_cpulist(read_line(std::string(SYSTEM_NODE) + "/online")))
+        {
+            for(auto cpu : parse_cpulist(read_line(std::string(SYSTEM_NODE) + "/node" + std::to_string(node) + "/cpulist")))
+            {
+                if (cpu >= static_cast<int>(ret.size()))
+                    ret.resize(cpu + 1, -1);
+                ret[cpu] = node;
+            }
+        }
+
+        return ret;
+    }
+
+
+    std::vector<std::string>
+    select_queues(std::vector<std::string> entries)
+    {
+        entries.erase(std::remove_if(entries.begin(), entries.end(), [](const std::string &name) {
+                        return name.compare(0, 3, "rx-") != 0 && name.compare(0, 3, "tx-") != 0;
+                      }), entries.end());
+
+        // rx before tx, by queue number
+        //
+        std::sort(entries.begin(), entries.end(), [](const std::string &a, const std::string &b) {
+                    return a[0] != b[0] ? a[0] < b[0] : atoi(a.c_str() + 3) < atoi(b.c_str() + 3);
+                  });
+        return entries;
+    }
+
+
+    std::vector<std::string>
+    get_queues(const std::string &ifname)
+    {
+        std::vector<std::string> ret;
+
+        DIR *d = opendir((std::string(CLASS_NET) + '/' + ifname + "/queues").c_str());
+        if (!d)
+            return ret;
+
+        while (auto e = readdir(d))
+            ret.emplace_back(e->d_name);
+
+        closedir(d);
+        return select_queues(std::move(ret));
+    }
+
+} // namespace sysfs
+} // namespace ifshow
+
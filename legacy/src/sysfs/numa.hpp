@@ -0,0 +1,68 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <sysfs/files.hpp>
+
+namespace ifshow { namespace sysfs {
+
+    static const char SYSTEM_NODE []= "/sys/devices/system/node";
+
+    // the NUMA node of the device of an interface (-1 if unknown) and the
+    // CPUs local to it (from the parent PCI function for virtio)
+    //
+    struct device_numa
+    {
+        int                 node;
+        std::vector<int>    local_cpus;
+    };
+
+    extern device_numa get_device_numa(const std::string &ifname);
+
+    // the node of each CPU, -1 if unknown
+    //
+    extern std::vector<int> get_cpu_nodes();
+
+    // the queues of an interface (rx-0, rx-1..., tx-0...)
+    //
+    extern std::vector<std::string> get_queues(const std::string &ifname);
+
+    // the rx-N/tx-N entries of a queues directory, rx before tx by number
+    //
+    extern std::vector<std::string> select_queues(std::vector<std::string> entries);
+
+    // "0-3,8" <-> { 0, 1, 2, 3, 8 }
+    //
+    extern std::vector<int> parse_cpulist(const std::string &list);
+    extern std::string format_cpulist(const std::vector<int> &cpus);
+
+    // "ff,00000001" -> { 0, 32, 33... 39 }
+    //
+    extern std::vector<int> parse_cpumask(const std::string &mask);
+
+    // the first line of a sysfs/procfs file ("" if it can't be read)
+    //
+    extern std::string read_line(const std::string &path);
+
+} // namespace sysfs
+} // namespace ifshow
+
@@ -0,0 +1,149 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <system_error>
+
+#include <sysfs/stats.hpp>
+
+namespace ifshow { namespace sysfs {
+
+    const char * const stats_sampler::counter_name[stats_sampler::max_counter] =
+    {
+        "rx_bytes",
+        "rx_packets",
+        "rx_errors",
+        "rx_dropped",
+        "rx_fifo_errors",
+        "rx_frame_errors",
+        "tx_bytes",
+        "tx_packets",
+        "tx_errors",
+        "tx_dropped",
+        "tx_fifo_errors",
+        "collisions",
+    };
+
+
+    static std::vector<stats_sampler::counter>
+    all_counters()
+    {
+        std::vector<stats_sampler::counter> ret;
+        for(int c = 0; c < stats_sampler::max_counter; c++)
+            ret.push_back(static_cast<stats_sampler::counter>(c));
+        return ret;
+    }
+
+
+    stats_sampler::stats_sampler(std::vector<ifname> ifs)
+    : stats_sampler(std::move(ifs), all_counters())
+    {}
+
+
+    stats_sampler::stats_sampler(std::vector<ifname> ifs, std::vector<counter> cnts)
+    : m_ifs(std::move(ifs))
+    , m_counters(std::move(cnts))
+    , m_fds()
+    , m_failed((m_ifs.size() + 63) / 64)
+    {
+        m_fds.reserve(m_ifs.size() * m_counters.size());
+
+        for(auto const &name : m_ifs)
+        {
+            for(auto c : m_counters)
+            {
+                std::string path = std::string(CLASS_NET) + '/' + name.c_str() + "/statistics/" + counter_name[c];
+
+                int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                if (fd == -1) {
+                    int err = errno;
+                    for(auto f : m_fds)
+                        ::close(f);
+                    throw std::system_error(err, std::generic_category(), path);
+                }
+
+                m_fds.push_back(fd);
+            }
+        }
+    }
+
+
+    stats_sampler::~stats_sampler()
+    {
+        for(auto fd : m_fds)
+            ::close(fd);
+    }
+
+
+    static inline bool
+    read_counter(int fd, uint64_t &value)
+    {
+        char buf[32];
+
+        ssize_t n = ::pread(fd, buf, sizeof(buf), 0);
+        if (n < 0)
+            return false;
+
+        // sysfs counters are a decimal number followed by '\n'
+        //
+        value = 0;
+        for(ssize_t i = 0; i < n; i++)
+        {
+            unsigned int d = static_cast<unsigned char>(buf[i]) - '0';
+            if (d > 9)
+                break;
+            value = value * 10 + d;
+        }
+
+        return true;
+    }
+
+
+    size_t
+    stats_sampler::sample(uint64_t *out) const
+    {
+        size_t failed = 0, nc = m_counters.size();
+
+        std::fill(m_failed.begin(), m_failed.end(), 0);
+
+        for(size_t i = 0; i < m_ifs.size(); i++, out += nc)
+        {
+            const int *fd = &m_fds[i * nc];
+
+            for(size_t c = 0; c < nc; c++)
+            {
+                if (!read_counter(fd[c], out[c])) {
+                    std::fill(out, out + nc, 0);
+                    m_failed[i / 64] |= uint64_t(1) << (i % 64);
+                    failed++;
+                    break;
+                }
+            }
+        }
+
+        return failed;
+    }
+
+} // namespace sysfs
+} // namespace ifshow
+
@@ -0,0 +1,135 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <sysfs/files.hpp>
+
+#include <ifname.hpp>
+
+namespace ifshow { namespace sysfs {
+
+    /*
+     * stats_sampler keeps /sys/class/net/<if>/statistics/<counter> open and
+     * re-reads the selected counters with pread(). The cost of a sample
+     * depends only on the number of interfaces selected, not on the number
+     * of interfaces in the system (as it happens with /proc/net/dev).
+     *
+     * Samples are stored row-major: value(i, c) = out[i * counters() + c].
+     *
+     * An interface deleted after the sampler is built keeps failing (its
+     * files return ENODEV): its counters read as 0 and failed(i) is set,
+     * the other interfaces are sampled as usual.
+     */
+
+    class stats_sampler
+    {
+    public:
+        enum counter
+        {
+            rx_bytes,
+            rx_packets,
+            rx_errors,
+            rx_dropped,
+            rx_fifo_errors,
+            rx_frame_errors,
+            tx_bytes,
+            tx_packets,
+            tx_errors,
+            tx_dropped,
+            tx_fifo_errors,
+            collisions,
+            max_counter
+        };
+
+        static const char * const counter_name[max_counter];
+
+        explicit stats_sampler(std::vector<ifname> ifs);
+        stats_sampler(std::vector<ifname> ifs, std::vector<counter> cnts);
+
+        ~stats_sampler();
+
+        stats_sampler(const stats_sampler &) = delete;
+        stats_sampler& operator=(const stats_sampler &) = delete;
+
+        size_t
+        interfaces() const
+        {
+            return m_ifs.size();
+        }
+
+        size_t
+        counters() const
+        {
+            return m_counters.size();
+        }
+
+        size_t
+        size() const
+        {
+            return m_fds.size();
+        }
+
+        const ifname &
+        name(size_t i) const
+        {
+            return m_ifs[i];
+        }
+
+        counter
+        which(size_t c) const
+        {
+            return m_counters[c];
+        }
+
+        // read all the counters into out[0..size()): returns the number of
+        // interfaces that failed
+        //
+        size_t sample(uint64_t *out) const;
+
+        // the counters of interface i could not be read by the last sample
+        //
+        bool
+        failed(size_t i) const
+        {
+            return (m_failed[i / 64] >> (i % 64)) & 1;
+        }
+
+        std::vector<uint64_t>
+        sample() const
+        {
+            std::vector<uint64_t> ret(size());
+            sample(ret.data());
+            return ret;
+        }
+
+    private:
+        std::vector<ifname>      m_ifs;
+        std::vector<counter>     m_counters;
+        std::vector<int>         m_fds;
+        mutable std::vector<uint64_t> m_failed;
+    };
+
+} // namespace sysfs
+} // namespace ifshow
+
@@ -0,0 +1,359 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#include <sysfs/stats.hpp>
+
+#include <watch/spsc.hpp>
+#include <watch/watch.hpp>
+
+#include <colors.hpp>
+
+namespace ifshow { namespace watch {
+
+    typedef sysfs::stats_sampler s;
+
+    // the counters sampled in burst mode, per interface
+    //
+    enum { b_rx_bytes, b_rx_packets, b_rx_dropped, b_tx_bytes, b_tx_packets, b_tx_dropped, b_max };
+
+    static const std::vector<s::counter> burst_counters =
+    {
+        s::rx_bytes, s::rx_packets, s::rx_dropped, s::tx_bytes, s::tx_packets, s::tx_dropped
+    };
+
+    // a burst is a run of samples above this fraction of the line rate (or
+    // above twice the mean rate of the window, when the speed is unknown)
+    //
+    static const double BURST_LINE_RATE = 0.5;
+    static const double BURST_MEAN      = 2.0;
+
+    struct window
+    {
+        double              rx_peak_bps = 0, tx_peak_bps = 0;
+        double              rx_peak_pps = 0, tx_peak_pps = 0;
+        uint64_t            rx_bytes = 0, tx_bytes = 0, drops = 0;
+        std::vector<float>  rx_bps, tx_bps;     // per sample
+    };
+
+
+    static uint64_t
+    now_ns()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return uint64_t(ts.tv_sec) * 1000000000 + uint64_t(ts.tv_nsec);
+    }
+
+
+    // link speed in bit/s, 0 if unknown (virtual interfaces, link down)
+    //
+    static double
+    link_speed(const std::string &name)
+    {
+        std::ifstream in(std::string(sysfs::CLASS_NET) + '/' + name + "/speed");
+        long mbps = 0;
+        if (!(in >> mbps) || mbps <= 0)
+            return 0;
+        return mbps * 1e6;
+    }
+
+
+    // pin the calling thread to the last CPU it is allowed to run on
+    //
+    static int
+    pin_last_cpu()
+    {
+        cpu_set_t set;
+        if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+            return -1;
+
+        for(int cpu = CPU_SETSIZE - 1; cpu >= 0; cpu--)
+        {
+            if (CPU_ISSET(cpu, &set)) {
+                CPU_ZERO(&set);
+                CPU_SET(cpu, &set);
+                return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0 ? cpu : -1;
+            }
+        }
+
+        return -1;
+    }
+
+
+    // number of runs above threshold and the duration of the longest one (secs)
+    //
+    static std::pair<size_t, double>
+    find_bursts(const std::vector<float> &bps, const std::vector<float> &dt, double threshold)
+    {
+        size_t runs = 0;
+        double run = 0, longest = 0;
+
+        for(size_t i = 0; i < bps.size(); i++)
+        {
+            if (bps[i] > threshold) {
+                if (run == 0)
+                    runs++;
+                run += dt[i];
+                longest = std::max(longest, run);
+            }
+            else
+                run = 0;
+        }
+
+        return std::make_pair(runs, longest);
+    }
+
+
+    static void
+    print_window(const std::vector<ifname> &ifs, const std::vector<double> &speed, const std::vector<window> &win,
+                 const std::vector<float> &dt, uint64_t stalls, size_t width)
+    {
+        double secs = 0, min_dt = dt.empty() ? 0 : dt[0], max_dt = min_dt;
+        for(auto d : dt) {
+            secs += d;
+            min_dt = std::min<double>(min_dt, d);
+            max_dt = std::max<double>(max_dt, d);
+        }
+
+        std::cout << std::fixed << std::setprecision(3) << "samples:" << dt.size() << " interval:" << (dt.empty() ? 0 : secs / dt.size()) * 1e3
+                  << "ms (" << min_dt * 1e3 << "-" << max_dt * 1e3 << ") stalls:" << stalls << std::endl;
+
+        std::cout << bold() << std::left << std::setw(width) << "iface" << std::right
+                  << std::setw(10) << "rx bps" << std::setw(10) << "rx peak"
+                  << std::setw(10) << "tx bps" << std::setw(10) << "tx peak"
+                  << std::setw(10) << "peak pps" << std::setw(10) << "bursts"
+                  << std::setw(10) << "longest" << std::setw(10) << "drops" << reset() << std::endl;
+
+        for(size_t i = 0; i < ifs.size(); i++)
+        {
+            auto &w = win[i];
+
+            double rx_bps = secs ? w.rx_bytes * 8 / secs : 0;
+            double tx_bps = secs ? w.tx_bytes * 8 / secs : 0;
+
+            auto rx = find_bursts(w.rx_bps, dt, speed[i] ? speed[i] * BURST_LINE_RATE : rx_bps * BURST_MEAN);
+            auto tx = find_bursts(w.tx_bps, dt, speed[i] ? speed[i] * BURST_LINE_RATE : tx_bps * BURST_MEAN);
+
+            std::ostringstream bursts, longest;
+            bursts << rx.first << '/' << tx.first;
+            longest << std::fixed << std::setprecision(1) << std::max(rx.second, tx.second) * 1e3 << "ms";
+
+            std::cout << cyan() << std::left << std::setw(width) << ifs[i] << reset() << std::right
+                      << std::setw(10) << human(rx_bps) << std::setw(10) << human(w.rx_peak_bps)
+                      << std::setw(10) << human(tx_bps) << std::setw(10) << human(w.tx_peak_bps)
+                      << std::setw(10) << human(std::max(w.rx_peak_pps, w.tx_peak_pps))
+                      << std::setw(10) << bursts.str() << std::setw(10) << longest.str();
+
+            if (w.drops)
+                std::cout << red();
+            std::cout << std::setw(10) << w.drops << reset() << std::endl;
+        }
+    }
+
+
+    int
+    burst_interfaces(const options &opts)
+    try
+    {
+        auto ifs = select_interfaces(opts);
+        if (ifs.empty())
+            throw std::runtime_error("no interface to watch");
+
+        size_t width = 0;
+        std::vector<double> speed;
+        for(auto &name : ifs) {
+            width = std::max(width, name.size() + 2);
+            speed.push_back(link_speed(name));
+        }
+
+        s sampler(ifs, burst_counters);
+
+        uint64_t period_ns = static_cast<uint64_t>(opts.burst * 1e6);
+        uint64_t window_ns = static_cast<uint64_t>((opts.watch > 0 ? opts.watch : 1.0) * 1e9);
+
+        // records are { timestamp, counters... }; the ring holds a few windows
+        // so that a slow consumer never makes the sampler wait
+        //
+        spsc_ring ring(std::max<size_t>(4096, 4 * window_ns / period_ns), 1 + sampler.size());
+
+        std::atomic<bool> stop(false);
+        std::atomic<uint64_t> stalls(0);
+        std::exception_ptr error;
+        std::atomic<bool> failed(false);
+
+        std::thread producer([&]
+        {
+            try
+            {
+                pin_last_cpu();
+
+                struct timespec next;
+                clock_gettime(CLOCK_MONOTONIC, &next);
+
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    // never drop a sample: wait for the consumer instead
+                    //
+                    uint64_t *rec;
+                    while (!(rec = ring.back())) {
+                        if (stop.load(std::memory_order_relaxed))
+                            return;
+                        stalls.fetch_add(1, std::memory_order_relaxed);
+                        std::this_thread::yield();
+                    }
+
+                    // a deleted interface reads as 0: its deltas are 0
+                    //
+                    sampler.sample(rec + 1);
+                    rec[0] = now_ns();
+                    ring.push();
+
+                    uint64_t t = uint64_t(next.tv_sec) * 1000000000 + uint64_t(next.tv_nsec) + period_ns;
+
+                    // late (e.g. preempted): restart the schedule from now,
+                    // rather than sampling back-to-back to catch up
+                    //
+                    if (t <= rec[0])
+                        t = rec[0] + period_ns;
+
+                    next.tv_sec  = static_cast<time_t>(t / 1000000000);
+                    next.tv_nsec = static_cast<long>(t % 1000000000);
+
+                    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr) == EINTR)
+                    { }
+                }
+            }
+            catch(...)
+            {
+                error = std::current_exception();
+                failed.store(true, std::memory_order_release);
+            }
+        });
+
+        // aggregate the samples into windows (on this thread)
+        //
+        std::vector<uint64_t> prev(sampler.size());
+        std::vector<window> win(ifs.size());
+        std::vector<float> dt;
+
+        uint64_t prev_ns = 0, window_start = 0;
+        unsigned long reported = 0;
+
+        while (opts.count == 0 || reported < opts.count)
+        {
+            const uint64_t *rec = ring.front();
+            if (!rec) {
+                if (failed.load(std::memory_order_acquire))
+                    break;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+
+            uint64_t ns = rec[0];
+            const uint64_t *cur = rec + 1;
+
+            // a sample taken too close to the previous one (the sampler
+            // woke up late) is merged into the next interval: the counters
+            // are cumulative, so nothing is lost and peaks are not inflated
+            //
+            if (prev_ns && ns - prev_ns < period_ns / 2) {
+                ring.pop();
+                continue;
+            }
+
+            if (prev_ns)
+            {
+                double secs = (ns - prev_ns) / 1e9;
+                dt.push_back(static_cast<float>(secs));
+
+                for(size_t i = 0; i < ifs.size(); i++)
+                {
+                    const uint64_t *p = &prev[i * b_max], *c = &cur[i * b_max];
+                    uint64_t d[b_max];
+                    for(int k = 0; k < b_max; k++)
+                        d[k] = c[k] >= p[k] ? c[k] - p[k] : 0;
+
+                    auto &w = win[i];
+
+                    double rx_bps = d[b_rx_bytes] * 8 / secs, tx_bps = d[b_tx_bytes] * 8 / secs;
+
+                    w.rx_bps.push_back(static_cast<float>(rx_bps));
+                    w.tx_bps.push_back(static_cast<float>(tx_bps));
+
+                    w.rx_peak_bps = std::max(w.rx_peak_bps, rx_bps);
+                    w.tx_peak_bps = std::max(w.tx_peak_bps, tx_bps);
+                    w.rx_peak_pps = std::max(w.rx_peak_pps, d[b_rx_packets] / secs);
+                    w.tx_peak_pps = std::max(w.tx_peak_pps, d[b_tx_packets] / secs);
+
+                    w.rx_bytes += d[b_rx_bytes];
+                    w.tx_bytes += d[b_tx_bytes];
+                    w.drops    += d[b_rx_dropped] + d[b_tx_dropped];
+                }
+            }
+            else
+                window_start = ns;
+
+            std::copy(cur, cur + sampler.size(), prev.begin());
+            prev_ns = ns;
+            ring.pop();
+
+            if (ns - window_start >= window_ns)
+            {
+                if (reported++)
+                    std::cout << std::endl;
+
+                print_window(ifs, speed, win, dt, stalls.exchange(0), width);
+                std::cout << std::flush;
+
+                win.assign(ifs.size(), window());
+                dt.clear();
+                window_start = ns;
+            }
+        }
+
+        stop.store(true);
+        producer.join();
+
+        if (error)
+            std::rethrow_exception(error);
+
+        return 0;
+    }
+    catch(std::exception &e)
+    {
+        std::cerr << "ifshow: " << e.what() << std::endl;
+        return 1;
+    }
+
+} // namespace watch
+} // namespace ifshow
+
@@ -0,0 +1,178 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#if defined(__AVX2__) || defined(__SSE4_2__)
+#include <immintrin.h>
+#endif
+
+#include <watch/delta.hpp>
+
+namespace ifshow { namespace watch {
+
+    static inline uint64_t
+    backward_delta(uint64_t p, uint64_t c, delta_result &ret)
+    {
+        // a 32-bit counter that wrapped moved forward by less than 2^31
+        //
+        if (p <= UINT32_MAX) {
+            uint64_t w = (uint64_t(1) << 32) - p + c;
+            if (w < (uint64_t(1) << 31)) {
+                ret.wrapped++;
+                return w;
+            }
+        }
+
+        ret.reset++;
+        return c;
+    }
+
+
+    static inline uint64_t
+    scalar_delta(uint64_t p, uint64_t c, delta_result &ret)
+    {
+        return c < p ? backward_delta(p, c, ret) : c - p;
+    }
+
+
+    /*
+     * SIMD subtract over a block of 64 counters: returns the non-zero mask
+     * and sets in back the counters that went backwards.
+     */
+
+#if defined(__AVX2__)
+    static inline uint64_t
+    block_delta(const uint64_t *prev, const uint64_t *cur, uint64_t *delta, uint64_t &back)
+    {
+        // unsigned a > b is computed as signed (a ^ 2^63) > (b ^ 2^63)
+        //
+        const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+        const __m256i zero = _mm256_setzero_si256();
+
+        uint64_t nz = 0, bk = 0;
+
+        for(unsigned int j = 0; j < 64; j += 4)
+        {
+            __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(prev + j));
+            __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(cur + j));
+            __m256i d = _mm256_sub_epi64(c, p);
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(delta + j), d);
+
+            __m256i b = _mm256_cmpgt_epi64(_mm256_xor_si256(p, sign), _mm256_xor_si256(c, sign));
+            __m256i z = _mm256_cmpeq_epi64(d, zero);
+
+            bk |= uint64_t(_mm256_movemask_pd(_mm256_castsi256_pd(b))) << j;
+            nz |= uint64_t(_mm256_movemask_pd(_mm256_castsi256_pd(z))) << j;
+        }
+
+        back = bk;
+        return ~nz;
+    }
+#elif defined(__SSE4_2__)
+    static inline uint64_t
+    block_delta(const uint64_t *prev, const uint64_t *cur, uint64_t *delta, uint64_t &back)
+    {
+        const __m128i sign = _mm_set1_epi64x(INT64_MIN);
+        const __m128i zero = _mm_setzero_si128();
+
+        uint64_t nz = 0, bk = 0;
+
+        for(unsigned int j = 0; j < 64; j += 2)
+        {
+            __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i *>(prev + j));
+            __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(cur + j));
+            __m128i d = _mm_sub_epi64(c, p);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(delta + j), d);
+
+            __m128i b = _mm_cmpgt_epi64(_mm_xor_si128(p, sign), _mm_xor_si128(c, sign));
+            __m128i z = _mm_cmpeq_epi64(d, zero);
+
+            bk |= uint64_t(_mm_movemask_pd(_mm_castsi128_pd(b))) << j;
+            nz |= uint64_t(_mm_movemask_pd(_mm_castsi128_pd(z))) << j;
+        }
+
+        back = bk;
+        return ~nz;
+    }
+#else
+    static inline uint64_t
+    block_delta(const uint64_t *prev, const uint64_t *cur, uint64_t *delta, uint64_t &back)
+    {
+        uint64_t nz = 0, bk = 0;
+
+        for(unsigned int j = 0; j < 64; j++)
+        {
+            delta[j] = cur[j] - prev[j];
+            bk |= uint64_t(cur[j] < prev[j]) << j;
+            nz |= uint64_t(delta[j] != 0) << j;
+        }
+
+        back = bk;
+        return nz;
+    }
+#endif
+
+
+    delta_result
+    counter_delta(const uint64_t *prev, const uint64_t *cur, uint64_t *delta, uint64_t *mask, size_t n)
+    {
+        delta_result ret = { 0, 0, 0 };
+
+        size_t i = 0;
+
+        for(; i + 64 <= n; i += 64)
+        {
+            uint64_t back;
+            uint64_t m = block_delta(prev + i, cur + i, delta + i, back);
+
+            // wraps and resets are rare: fix them up one by one
+            //
+            for(; back; back &= back - 1)
+            {
+                unsigned int j = __builtin_ctzll(back);
+                uint64_t d = backward_delta(prev[i + j], cur[i + j], ret);
+                delta[i + j] = d;
+                m = (m & ~(uint64_t(1) << j)) | (uint64_t(d != 0) << j);
+            }
+
+            mask[i / 64] = m;
+            ret.changed += __builtin_popcountll(m);
+        }
+
+        if (i < n)
+        {
+            uint64_t m = 0;
+            for(unsigned int j = 0; i + j < n; j++)
+            {
+                uint64_t d = scalar_delta(prev[i + j], cur[i + j], ret);
+                delta[i + j] = d;
+                m |= uint64_t(d != 0) << j;
+            }
+
+            mask[i / 64] = m;
+            ret.changed += __builtin_popcountll(m);
+        }
+
+        return ret;
+    }
+
+} // namespace watch
+} // namespace ifshow
+
@@ -0,0 +1,55 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ifshow { namespace watch {
+
+    struct delta_result
+    {
+        size_t changed;     // counters with a non-zero delta
+        size_t wrapped;     // 32-bit counters that wrapped around
+        size_t reset;       // counters that went backwards (driver/link reset)
+    };
+
+    // number of u64 words of the change mask for n counters
+    //
+    inline size_t
+    mask_words(size_t n)
+    {
+        return (n + 63) / 64;
+    }
+
+    /*
+     * delta[i] = cur[i] - prev[i], for i in [0, n).
+     *
+     * A counter that goes backwards is either a 32-bit counter that wrapped
+     * (the delta is taken modulo 2^32) or a counter that was reset (the delta
+     * is the current value). Bit i of mask is set when delta[i] != 0.
+     */
+
+    extern delta_result
+    counter_delta(const uint64_t *prev, const uint64_t *cur, uint64_t *delta, uint64_t *mask, size_t n);
+
+} // namespace watch
+} // namespace ifshow
+
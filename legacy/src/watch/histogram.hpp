@@ -0,0 +1,142 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace ifshow { namespace watch {
+
+    /*
+     * HDR-style histogram of non-negative values, in fixed memory (~4KB).
+     *
+     * Values below 32 have their own bucket; above, each power of 2 is split
+     * in 16 linear sub-buckets, so that the bucket of a value is within
+     * 1/16 of it (percentiles are reported at the bucket midpoint, ~3%).
+     * record() is O(1), merge() is a plain sum of the buckets.
+     */
+
+    class histogram
+    {
+    public:
+        static const unsigned int sub_bits = 5;
+        static const unsigned int buckets  = (1U << sub_bits) + (64 - sub_bits) * (1U << (sub_bits - 1));
+
+        histogram()
+        : m_count()
+        , m_total(0)
+        , m_max(0)
+        {}
+
+        void
+        record(uint64_t value)
+        {
+            m_count[index(value)]++;
+            m_total++;
+            m_max = std::max(m_max, value);
+        }
+
+        void
+        merge(const histogram &other)
+        {
+            for(unsigned int i = 0; i < buckets; i++)
+                m_count[i] += other.m_count[i];
+            m_total += other.m_total;
+            m_max = std::max(m_max, other.m_max);
+        }
+
+        uint64_t
+        count() const
+        {
+            return m_total;
+        }
+
+        uint64_t
+        max() const
+        {
+            return m_max;
+        }
+
+        // the value at percentile p (0-100)
+        //
+        uint64_t
+        percentile(double p) const
+        {
+            if (m_total == 0)
+                return 0;
+
+            uint64_t rank = static_cast<uint64_t>(p / 100.0 * m_total + 0.5);
+            rank = std::max<uint64_t>(1, std::min(rank, m_total));
+
+            uint64_t seen = 0;
+            for(unsigned int i = 0; i < buckets; i++)
+            {
+                seen += m_count[i];
+                if (seen >= rank)
+                    return std::min(midpoint(i), m_max);
+            }
+
+            return m_max;
+        }
+
+        static unsigned int
+        index(uint64_t value)
+        {
+            if (value < (1U << sub_bits))
+                return static_cast<unsigned int>(value);
+
+            unsigned int shift = 64 - __builtin_clzll(value) - sub_bits;    // >= 1
+            unsigned int mant  = static_cast<unsigned int>(value >> shift); // [16, 32)
+
+            return (1U << sub_bits) + (shift - 1) * (1U << (sub_bits - 1)) + (mant - (1U << (sub_bits - 1)));
+        }
+
+        static uint64_t
+        lower_bound(unsigned int i)
+        {
+            if (i < (1U << sub_bits))
+                return i;
+
+            unsigned int j     = i - (1U << sub_bits);
+            unsigned int shift = j / (1U << (sub_bits - 1)) + 1;
+            uint64_t     mant  = j % (1U << (sub_bits - 1)) + (1U << (sub_bits - 1));
+
+            return mant << shift;
+        }
+
+        static uint64_t
+        midpoint(unsigned int i)
+        {
+            if (i < (1U << sub_bits))
+                return i;
+
+            unsigned int shift = (i - (1U << sub_bits)) / (1U << (sub_bits - 1)) + 1;
+            return lower_bound(i) + (uint64_t(1) << (shift - 1));
+        }
+
+    private:
+        std::array<uint32_t, buckets>   m_count;
+        uint64_t                        m_total;
+        uint64_t                        m_max;
+    };
+
+} // namespace watch
+} // namespace ifshow
+
@@ -0,0 +1,228 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+#include <proc/interrupt.hpp>
+#include <proc/softnet.hpp>
+
+#include <watch/watch.hpp>
+
+#include <colors.hpp>
+
+namespace ifshow { namespace watch {
+
+    static void
+    print_irqs(const std::string &ifname, const std::vector<int> &irqs,
+               const std::unordered_map<std::string, const proc::interrupt *> &before,
+               const std::unordered_map<std::string, const proc::interrupt *> &after, double secs,
+               std::vector<double> &per_cpu)
+    {
+        std::cout << cyan() << ifname << reset();
+
+        if (irqs.empty()) {
+            std::cout << " no irq" << std::endl;
+            return;
+        }
+
+        std::cout << std::endl;
+
+        size_t width = 6;
+        for(auto irq : irqs)
+        {
+            auto it = after.find(std::to_string(irq));
+            if (it != after.end())
+                width = std::max(width, it->second->name().size() + 2);
+        }
+
+        std::cout << bold() << "  " << std::left << std::setw(6) << "irq" << std::setw(width) << "name"
+                  << std::setw(12) << "affinity" << std::setw(12) << "effective" << std::right
+                  << std::setw(10) << "irq/s" << "  per cpu" << reset() << std::endl;
+
+        for(auto irq : irqs)
+        {
+            auto key = std::to_string(irq);
+            auto a = after.find(key);
+            auto b = before.find(key);
+
+            auto affinity  = proc::get_irq_affinity(irq);
+            auto effective = proc::get_irq_affinity(irq, true);
+
+            std::cout << "  " << std::left << std::setw(6) << irq
+                      << std::setw(width) << (a != after.end() ? a->second->name() : "-")
+                      << std::setw(12) << (affinity.empty() ? "-" : affinity)
+                      << std::setw(12) << (effective.empty() ? "-" : effective) << std::right;
+
+            if (a == after.end() || b == before.end()) {
+                std::cout << std::endl;
+                continue;
+            }
+
+            auto &c1 = a->second->count, &c0 = b->second->count;
+
+            double total = 0;
+            std::ostringstream cpus;
+
+            // count is indexed by CPU id (as softnet), idle CPUs are not
+            // displayed
+            //
+            for(size_t cpu = 0; cpu < std::min(c0.size(), c1.size()); cpu++)
+            {
+                if (c1[cpu] <= c0[cpu])
+                    continue;
+
+                double rate = (c1[cpu] - c0[cpu]) / secs;
+                total += rate;
+
+                if (per_cpu.size() <= cpu)
+                    per_cpu.resize(cpu + 1);
+                per_cpu[cpu] += rate;
+                cpus << " cpu" << cpu << ':' << human(rate);
+            }
+
+            std::cout << std::setw(10) << human(total) << cpus.str() << std::endl;
+        }
+    }
+
+
+    // the per-CPU backlog: drops and squeezes here never show up in the
+    // interface counters. Displayed next to the NIC interrupts served by
+    // the same CPU, idle CPUs are skipped.
+    //
+    static void
+    print_softnet(const std::vector<proc::softnet> &before, const std::vector<proc::softnet> &after,
+                  const std::vector<double> &nic_irqs, double secs)
+    {
+        std::cout << cyan() << "softnet" << reset() << std::endl;
+        std::cout << bold() << "  " << std::left << std::setw(6) << "cpu" << std::right
+                  << std::setw(12) << "nic irq/s" << std::setw(12) << "processed/s" << std::setw(12) << "dropped/s"
+                  << std::setw(12) << "squeezed/s" << std::setw(14) << "flow_limit/s" << std::setw(10) << "rps/s"
+                  << reset() << std::endl;
+
+        size_t idle = 0;
+
+        for(size_t n = 0; n < std::min(before.size(), after.size()); n++)
+        {
+            auto &b = before[n], &a = after[n];
+            if (a.cpu != b.cpu)
+                continue;
+
+            // 32-bit counters: the unsigned difference survives a wrap
+            //
+            auto rate = [secs](uint32_t c, uint32_t p) { return static_cast<uint32_t>(c - p) / secs; };
+
+            double irq       = a.cpu >= 0 && static_cast<size_t>(a.cpu) < nic_irqs.size() ? nic_irqs[a.cpu] : 0;
+            double processed = rate(a.processed, b.processed);
+            double dropped   = rate(a.dropped, b.dropped);
+            double squeezed  = rate(a.time_squeeze, b.time_squeeze);
+            double limited   = rate(a.flow_limit, b.flow_limit);
+            double rps       = rate(a.received_rps, b.received_rps);
+
+            if (irq == 0 && processed == 0 && dropped == 0 && squeezed == 0 && limited == 0 && rps == 0) {
+                idle++;
+                continue;
+            }
+
+            std::cout << "  " << std::left << std::setw(6) << a.cpu << std::right
+                      << std::setw(12) << human(irq) << std::setw(12) << human(processed);
+
+            auto alert = [](double value, int width) {
+                if (value > 0)
+                    std::cout << red();
+                std::cout << std::setw(width) << human(value) << reset();
+            };
+
+            alert(dropped, 12);
+            alert(squeezed, 12);
+            alert(limited, 14);
+            std::cout << std::setw(10) << human(rps) << std::endl;
+        }
+
+        if (idle)
+            std::cout << "  (" << idle << " idle cpu" << (idle > 1 ? "s" : "") << ')' << std::endl;
+    }
+
+
+    int
+    irq_interfaces(const options &opts)
+    try
+    {
+        auto ifs = select_interfaces(opts);
+        if (ifs.empty())
+            throw std::runtime_error("no interface to display");
+
+        double interval = opts.watch > 0 ? opts.watch : 1.0;
+        unsigned long count = opts.count ? opts.count : opts.watch > 0 ? 0 : 1;
+
+        auto prev = proc::get_interrupts();
+        auto prev_softnet = proc::get_softnet_stat();
+        auto last = std::chrono::steady_clock::now();
+
+        for(unsigned long tick = 1; count == 0 || tick <= count; tick++)
+        {
+            std::this_thread::sleep_until(last + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(interval)));
+
+            auto cur = proc::get_interrupts();
+            auto cur_softnet = proc::get_softnet_stat();
+            auto now = std::chrono::steady_clock::now();
+            double secs = std::chrono::duration<double>(now - last).count();
+            last = now;
+
+            std::unordered_map<std::string, const proc::interrupt *> before, after;
+            for(auto &i : prev)
+                before.emplace(i.irq, &i);
+            for(auto &i : cur)
+                after.emplace(i.irq, &i);
+
+            if (tick > 1)
+                std::cout << std::endl;
+
+            std::vector<double> nic_irqs;
+
+            for(size_t n = 0; n < ifs.size(); n++)
+            {
+                if (n)
+                    std::cout << std::endl;
+                print_irqs(ifs[n], proc::get_interface_irqs(ifs[n], cur), before, after, secs, nic_irqs);
+            }
+
+            std::cout << std::endl;
+            print_softnet(prev_softnet, cur_softnet, nic_irqs, secs);
+
+            std::cout << std::flush;
+            prev = std::move(cur);
+            prev_softnet = std::move(cur_softnet);
+        }
+
+        return 0;
+    }
+    catch(std::exception &e)
+    {
+        std::cerr << "ifshow: " << e.what() << std::endl;
+        return 1;
+    }
+
+} // namespace watch
+} // namespace ifshow
+
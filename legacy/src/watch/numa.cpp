@@ -0,0 +1,183 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <unordered_map>
+
+#include <proc/interrupt.hpp>
+#include <sysfs/batch.hpp>
+#include <sysfs/numa.hpp>
+
+#include <watch/watch.hpp>
+
+#include <colors.hpp>
+
+namespace ifshow { namespace watch {
+
+    enum locality { none, local, mixed, remote };
+
+    static const char * const locality_name[] = { "-", "local", "mixed", "remote" };
+
+    // where the CPUs serving a queue are, with respect to the device
+    //
+    static locality
+    get_locality(const std::vector<int> &cpus, const std::vector<int> &local_cpus)
+    {
+        if (cpus.empty() || local_cpus.empty())
+            return none;
+
+        size_t in = 0;
+        for(auto c : cpus)
+            in += std::binary_search(local_cpus.begin(), local_cpus.end(), c);
+
+        return in == cpus.size() ? local : in == 0 ? remote : mixed;
+    }
+
+
+    static std::string
+    remote_nodes(const std::vector<int> &cpus, const std::vector<int> &local_cpus, const std::vector<int> &cpu_node)
+    {
+        std::set<int> nodes;
+        for(auto c : cpus)
+        {
+            if (!std::binary_search(local_cpus.begin(), local_cpus.end(), c) &&
+                c < static_cast<int>(cpu_node.size()) && cpu_node[c] >= 0)
+                nodes.insert(cpu_node[c]);
+        }
+
+        std::string ret;
+        for(auto n : nodes)
+            ret += (ret.empty() ? " (node " : ",") + std::to_string(n);
+        return ret.empty() ? ret : ret + ")";
+    }
+
+
+    struct counter
+    {
+        size_t remote = 0, total = 0;
+    };
+
+
+    // the name of each numbered IRQ of the table (NMI, LOC... skipped)
+    //
+    static std::unordered_map<int, std::string>
+    irq_names(const std::vector<proc::interrupt> &table)
+    {
+        std::unordered_map<int, std::string> ret;
+        for(auto &i : table)
+            if (auto irq = more::try_lexical_cast<int>(i.irq))
+                ret[*irq] = i.name();
+        return ret;
+    }
+
+
+    static void
+    print_numa(sysfs::batch_reader &reader, const std::string &ifname, const std::vector<proc::interrupt> &table,
+               const std::unordered_map<int, std::string> &names, const std::vector<int> &cpu_node)
+    {
+        auto numa = sysfs::get_device_numa(ifname);
+
+        std::cout << cyan() << ifname << reset() << " node:";
+        if (numa.node >= 0)
+            std::cout << numa.node;
+        else
+            std::cout << '-';
+        std::cout << " local cpus:" << (numa.local_cpus.empty() ? "-" : sysfs::format_cpulist(numa.local_cpus)) << std::endl;
+
+        counter irqs, rps, xps;
+
+        auto line = [&](const std::string &what, const std::string &name, const std::vector<int> &cpus, counter &cnt)
+        {
+            auto loc = get_locality(cpus, numa.local_cpus);
+
+            cnt.total++;
+            if (loc == remote || loc == mixed)
+                cnt.remote++;
+
+            std::cout << "  " << std::left << std::setw(10) << what << std::setw(20) << name
+                      << std::setw(16) << (cpus.empty() ? "-" : sysfs::format_cpulist(cpus));
+
+            if (loc == remote || loc == mixed)
+                std::cout << red();
+            std::cout << locality_name[loc] << remote_nodes(cpus, numa.local_cpus, cpu_node) << reset() << std::endl;
+        };
+
+        // the IRQs, by effective affinity when available
+        //
+        for(auto irq : proc::get_interface_irqs(ifname, table))
+        {
+            auto aff = proc::get_irq_affinity(irq, true);
+            if (aff.empty())
+                aff = proc::get_irq_affinity(irq);
+
+            auto it = names.find(irq);
+            line("irq " + std::to_string(irq), it != names.end() ? it->second : "-", sysfs::parse_cpulist(aff), irqs);
+        }
+
+        // RPS/XPS: an empty mask is off, and can't be remote
+        //
+        for(auto &q : sysfs::get_queues(ifname))
+        {
+            bool rx = q[0] == 'r';
+            auto cpus = sysfs::parse_cpumask(std::string(reader.read(ifname + "/queues/" + q + (rx ? "/rps_cpus" : "/xps_cpus"))));
+            if (cpus.empty())
+                continue;
+
+            line(q, rx ? "rps" : "xps", cpus, rx ? rps : xps);
+        }
+
+        std::cout << "  remote: irq " << irqs.remote << '/' << irqs.total
+                  << " rps " << rps.remote << '/' << rps.total
+                  << " xps " << xps.remote << '/' << xps.total << std::endl;
+    }
+
+
+    int
+    numa_interfaces(const options &opts)
+    try
+    {
+        auto ifs = select_interfaces(opts);
+        if (ifs.empty())
+            throw std::runtime_error("no interface to display");
+
+        auto table = proc::get_interrupts();
+        auto names = irq_names(table);
+        auto cpu_node = sysfs::get_cpu_nodes();
+        sysfs::batch_reader reader;
+
+        for(size_t n = 0; n < ifs.size(); n++)
+        {
+            if (n)
+                std::cout << std::endl;
+            print_numa(reader, ifs[n], table, names, cpu_node);
+        }
+
+        return 0;
+    }
+    catch(std::exception &e)
+    {
+        std::cerr << "ifshow: " << e.what() << std::endl;
+        return 1;
+    }
+
+} // namespace watch
+} // namespace ifshow
+
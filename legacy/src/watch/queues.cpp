@@ -0,0 +1,153 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#include <iomanip>
+#include <iostream>
+
+#include <sysfs/batch.hpp>
+#include <sysfs/numa.hpp>
+
+#include <watch/watch.hpp>
+
+#include <colors.hpp>
+
+namespace ifshow { namespace watch {
+
+    // the configuration of a queue: rps_cpus/rps_flow_cnt for the rx
+    // queues, xps_cpus/xps_rxqs for the tx ones
+    //
+    struct queue_conf
+    {
+        std::string name;
+        std::string cpus;
+        std::string extra;
+
+        bool operator==(const queue_conf &other) const
+        {
+            return cpus == other.cpus && extra == other.extra;
+        }
+    };
+
+
+    // a mask as a compact list, "off" if empty and "-" if it can't be read
+    //
+    static std::string
+    mask_list(std::string_view mask)
+    {
+        if (mask.empty())
+            return "-";
+        auto cpus = sysfs::parse_cpumask(std::string(mask));
+        return cpus.empty() ? "off" : sysfs::format_cpulist(cpus);
+    }
+
+
+    static void
+    print_group(const queue_conf &first, const queue_conf &last, size_t n)
+    {
+        std::string name = first.name;
+        if (n > 1)
+            name += ".." + last.name.substr(3);
+
+        std::cout << "  " << std::left << std::setw(12) << name
+                  << std::setw(20) << first.cpus << first.extra << std::endl;
+    }
+
+
+    static void
+    print_queues(sysfs::batch_reader &reader, const std::string &ifname)
+    {
+        std::vector<queue_conf> rx, tx;
+
+        // listed and read relative to the directory fd of the reader
+        //
+        for(auto &q : sysfs::select_queues(reader.list(ifname + "/queues")))
+        {
+            std::string dir = ifname + "/queues/" + q;
+
+            if (q[0] == 'r') {
+                queue_conf c { q, mask_list(reader.read(dir + "/rps_cpus")), std::string() };
+                auto cnt = reader.read(dir + "/rps_flow_cnt");
+                c.extra = cnt.empty() ? "-" : std::string(cnt);
+                rx.push_back(std::move(c));
+            }
+            else {
+                queue_conf c { q, mask_list(reader.read(dir + "/xps_cpus")), std::string() };
+                c.extra = mask_list(reader.read(dir + "/xps_rxqs"));
+                tx.push_back(std::move(c));
+            }
+        }
+
+        std::cout << cyan() << ifname << reset() << " rx:" << rx.size() << " tx:" << tx.size() << std::endl;
+
+        // consecutive queues with the same configuration are displayed
+        // as a range (rx-0..15)
+        //
+        auto table = [](const char *cpus, const char *extra, const std::vector<queue_conf> &queues)
+        {
+            if (queues.empty())
+                return;
+
+            std::cout << "  " << std::left << std::setw(12) << "queue" << std::setw(20) << cpus << extra << std::endl;
+
+            size_t first = 0;
+            for(size_t n = 1; n <= queues.size(); n++)
+            {
+                if (n == queues.size() || !(queues[n] == queues[first])) {
+                    print_group(queues[first], queues[n - 1], n - first);
+                    first = n;
+                }
+            }
+        };
+
+        table("rps_cpus", "rps_flow_cnt", rx);
+        table("xps_cpus", "xps_rxqs", tx);
+    }
+
+
+    int
+    queue_interfaces(const options &opts)
+    try
+    {
+        auto ifs = select_interfaces(opts);
+        if (ifs.empty())
+            throw std::runtime_error("no interface to display");
+
+        // RFS is enabled by the global flow table and rps_flow_cnt
+        //
+        auto entries = sysfs::read_line("/proc/sys/net/core/rps_sock_flow_entries");
+        std::cout << "rps_sock_flow_entries: " << (entries.empty() ? "-" : entries) << std::endl;
+
+        sysfs::batch_reader reader;
+
+        for(auto &ifname : ifs)
+        {
+            std::cout << std::endl;
+            print_queues(reader, ifname);
+        }
+
+        return 0;
+    }
+    catch(std::exception &e)
+    {
+        std::cerr << "ifshow: " << e.what() << std::endl;
+        return 1;
+    }
+
+} // namespace watch
+} // namespace ifshow
+
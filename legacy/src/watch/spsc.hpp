@@ -0,0 +1,115 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace ifshow { namespace watch {
+
+    /*
+     * Lock-free single-producer/single-consumer ring of fixed-size records
+     * (stride u64 each). The producer writes in place into back() and
+     * publishes with push(); the consumer reads front() and releases it with
+     * pop(). Each side caches the index of the other one, so that the shared
+     * cache lines are touched only when the ring looks full (or empty).
+     */
+
+    class spsc_ring
+    {
+    public:
+        spsc_ring(size_t records, size_t stride)
+        : m_head(0)
+        , m_tail_cache(0)
+        , m_tail(0)
+        , m_head_cache(0)
+        , m_capacity(1)
+        , m_stride(stride)
+        , m_data()
+        {
+            while (m_capacity < records)
+                m_capacity <<= 1;
+            m_data.resize(m_capacity * m_stride);
+        }
+
+        spsc_ring(const spsc_ring &) = delete;
+        spsc_ring& operator=(const spsc_ring &) = delete;
+
+        size_t
+        capacity() const
+        {
+            return m_capacity;
+        }
+
+        // producer: the record to fill, nullptr if the ring is full
+        //
+        uint64_t *
+        back()
+        {
+            size_t tail = m_tail.load(std::memory_order_relaxed);
+            if (tail - m_head_cache == m_capacity) {
+                m_head_cache = m_head.load(std::memory_order_acquire);
+                if (tail - m_head_cache == m_capacity)
+                    return nullptr;
+            }
+            return &m_data[(tail & (m_capacity - 1)) * m_stride];
+        }
+
+        void
+        push()
+        {
+            m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        // consumer: the oldest record, nullptr if the ring is empty
+        //
+        const uint64_t *
+        front()
+        {
+            size_t head = m_head.load(std::memory_order_relaxed);
+            if (head == m_tail_cache) {
+                m_tail_cache = m_tail.load(std::memory_order_acquire);
+                if (head == m_tail_cache)
+                    return nullptr;
+            }
+            return &m_data[(head & (m_capacity - 1)) * m_stride];
+        }
+
+        void
+        pop()
+        {
+            m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+    private:
+        alignas(64) std::atomic<size_t> m_head;         // consumer side
+        size_t                          m_tail_cache;
+
+        alignas(64) std::atomic<size_t> m_tail;         // producer side
+        size_t                          m_head_cache;
+
+        alignas(64) size_t              m_capacity;     // power of 2
+        size_t                          m_stride;
+        std::vector<uint64_t>           m_data;
+    };
+
+} // namespace watch
+} // namespace ifshow
+
@@ -0,0 +1,242 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+#include <net/if.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+#include <netlink/topology.hpp>
+
+#include <watch/watch.hpp>
+
+#include <colors.hpp>
+
+namespace ifshow { namespace watch {
+
+    struct row
+    {
+        std::string label;          // tree prefix + name
+        size_t      node;
+        const char *edge;           // "slave", "lower" or null for the roots
+        double      share;          // of the master traffic, slaves only (-1 otherwise)
+        size_t      siblings;       // the slaves of the same master
+        bool        repeated;       // a lower already displayed under another parent
+    };
+
+
+    static void
+    make_rows(const netlink::topology &topo, const std::vector<double> &total, size_t i, const std::string &prefix,
+              bool last, bool root, const char *edge, double share, size_t siblings, std::vector<char> &on_path,
+              std::vector<char> &shown, std::vector<row> &rows)
+    {
+        std::string label = root ? std::string() : prefix + (last ? "`- " : "|- ");
+        label += topo.links[i].name;
+
+        bool repeated = shown[i] || on_path[i];
+        rows.push_back(row{ label, i, edge, share, siblings, repeated });
+
+        if (repeated)
+            return;
+
+        shown[i] = on_path[i] = 1;
+
+        std::string next = root ? std::string() : prefix + (last ? "   " : "|  ");
+
+        auto &n = topo.nodes[i];
+        size_t count = n.slaves.size() + n.lowers.size(), k = 0;
+
+        for(auto s : n.slaves)
+        {
+            double sh = total[i] > 0 ? total[s] / total[i] : -1;
+            make_rows(topo, total, s, next, ++k == count, false, "slave", sh, n.slaves.size(), on_path, shown, rows);
+        }
+
+        for(auto l : n.lowers)
+            make_rows(topo, total, l, next, ++k == count, false, "lower", -1, 0, on_path, shown, rows);
+
+        on_path[i] = 0;
+    }
+
+
+    // the aggregated rate: the own rate for a leaf, the sum of the slaves for a master
+    //
+    static double
+    aggregate(const netlink::topology &topo, const std::vector<double> &own, size_t i, std::vector<double> &total,
+              std::vector<char> &visiting)
+    {
+        if (total[i] >= 0)
+            return total[i];
+
+        auto &n = topo.nodes[i];
+        if (n.slaves.empty() || visiting[i])
+            return total[i] = own[i];
+
+        visiting[i] = 1;
+
+        double sum = 0;
+        for(auto s : n.slaves)
+            sum += aggregate(topo, own, s, total, visiting);
+
+        visiting[i] = 0;
+        return total[i] = sum;
+    }
+
+
+    static void
+    print_tree(const netlink::topology &topo, const std::vector<double> &rx, const std::vector<double> &tx)
+    {
+        size_t n = topo.links.size();
+
+        std::vector<double> own(n), total(n, -1);
+        for(size_t i = 0; i < n; i++)
+            own[i] = rx[i] + tx[i];
+
+        std::vector<double> rx_total(n, -1), tx_total(n, -1);
+        std::vector<char> visiting(n);
+
+        for(size_t i = 0; i < n; i++) {
+            aggregate(topo, own, i, total, visiting);
+            aggregate(topo, rx, i, rx_total, visiting);
+            aggregate(topo, tx, i, tx_total, visiting);
+        }
+
+        std::vector<row> rows;
+        std::vector<char> on_path(n), shown(n);
+
+        for(auto r : topo.roots)
+            make_rows(topo, total, r, "", true, true, nullptr, -1, 0, on_path, shown, rows);
+
+        // the nodes in a cycle (not reachable from a root)
+        //
+        for(size_t i = 0; i < n; i++)
+            if (!shown[i])
+                make_rows(topo, total, i, "", true, true, nullptr, -1, 0, on_path, shown, rows);
+
+        size_t width = 5;
+        for(auto &r : rows)
+            width = std::max(width, r.label.length() + 2);
+
+        std::cout << bold() << std::left << std::setw(width) << "iface" << std::setw(8) << "edge" << std::right
+                  << std::setw(10) << "rx bps" << std::setw(10) << "tx bps"
+                  << std::setw(12) << "slaves rx" << std::setw(12) << "slaves tx" << std::setw(8) << "share" << reset() << std::endl;
+
+        for(auto &r : rows)
+        {
+            auto i = r.node;
+            auto &node = topo.nodes[i];
+
+            std::cout << cyan() << std::left << std::setw(width) << r.label << reset()
+                      << std::setw(8) << (r.edge ? r.edge : "") << std::right;
+
+            if (r.repeated) {
+                std::cout << std::setw(10) << "^" << std::endl;
+                continue;
+            }
+
+            std::cout << std::setw(10) << human(rx[i]) << std::setw(10) << human(tx[i]);
+
+            if (!node.slaves.empty())
+                std::cout << std::setw(12) << human(rx_total[i]) << std::setw(12) << human(tx_total[i]);
+            else if (r.share >= 0)
+                std::cout << std::setw(24) << "";
+
+            // a slave far from an even share of the master is highlighted
+            //
+            if (r.share >= 0)
+            {
+                double even = 1.0 / r.siblings;
+
+                std::ostringstream pct;
+                pct << std::fixed << std::setprecision(0) << r.share * 100 << '%';
+
+                if (r.share < even * 0.5 || r.share > even * 1.5)
+                    std::cout << red();
+                std::cout << std::setw(8) << pct.str() << reset();
+            }
+
+            std::cout << std::endl;
+        }
+    }
+
+
+    int
+    tree_interfaces(const options &opts)
+    try
+    {
+        double interval = opts.watch > 0 ? opts.watch : 1.0;
+        unsigned long count = opts.count ? opts.count : opts.watch > 0 ? 0 : 1;
+
+        auto prev = netlink::get_links();
+        auto last = std::chrono::steady_clock::now();
+
+        for(unsigned long tick = 1; count == 0 || tick <= count; tick++)
+        {
+            std::this_thread::sleep_until(last + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(interval)));
+
+            auto cur = netlink::get_links();
+            auto now = std::chrono::steady_clock::now();
+            double secs = std::chrono::duration<double>(now - last).count();
+            last = now;
+
+            std::unordered_map<int, const rtnl_link_stats64 *> before;
+            for(auto &l : prev)
+                if (l.has_stats)
+                    before.emplace(l.index, &l.stats);
+
+            auto topo = netlink::make_topology(cur);
+
+            std::vector<double> rx(topo.links.size()), tx(topo.links.size());
+            for(size_t i = 0; i < topo.links.size(); i++)
+            {
+                auto &l = topo.links[i];
+                auto it = before.find(l.index);
+                if (!l.has_stats || it == before.end())
+                    continue;
+
+                if (l.stats.rx_bytes >= it->second->rx_bytes)
+                    rx[i] = (l.stats.rx_bytes - it->second->rx_bytes) * 8 / secs;
+                if (l.stats.tx_bytes >= it->second->tx_bytes)
+                    tx[i] = (l.stats.tx_bytes - it->second->tx_bytes) * 8 / secs;
+            }
+
+            if (tick > 1)
+                std::cout << std::endl;
+
+            print_tree(topo, rx, tx);
+            std::cout << std::flush;
+
+            prev = std::move(cur);
+        }
+
+        return 0;
+    }
+    catch(std::exception &e)
+    {
+        std::cerr << "ifshow: " << e.what() << std::endl;
+        return 1;
+    }
+
+} // namespace watch
+} // namespace ifshow
+
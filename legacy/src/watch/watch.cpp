@@ -0,0 +1,669 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <net/if.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <system_error>
+#include <thread>
+#include <unordered_set>
+
+#include <iomanip.hpp>       // more
+
+#include <proc/net_dev.hpp>
+#include <sysfs/stats.hpp>
+#include <shm/ring.hpp>
+#include <ethtool/stats.hpp>
+
+#include <watch/delta.hpp>
+#include <watch/histogram.hpp>
+#include <watch/watch.hpp>
+
+#include <colors.hpp>
+#include <ifr.hpp>
+
+namespace ifshow { namespace watch {
+
+    struct nic
+    {
+        ifr                                             iif;
+        std::shared_ptr<const ethtool::stats_layout>    layout;     // null if not probed or not supported
+        size_t                                          offset;     // in the driver statistics arrays
+        size_t                                          room;       // the size of its region there
+        bool                                            probed;
+        unsigned long                                   sampled;    // last tick the statistics were read
+    };
+
+    struct rate
+    {
+        size_t  index;      // in the sampler
+        double  rx_bps;
+        double  rx_pps;
+        double  tx_bps;
+        double  tx_pps;
+        double  drops;
+        double  errors;
+    };
+
+    // the distribution of the per-tick rates of an interface
+    //
+    struct rate_histogram
+    {
+        histogram   rx_bps;
+        histogram   rx_pps;
+        histogram   tx_bps;
+        histogram   tx_pps;
+        histogram   drops;
+
+        void
+        record(const rate &r)
+        {
+            rx_bps.record(static_cast<uint64_t>(r.rx_bps + 0.5));
+            rx_pps.record(static_cast<uint64_t>(r.rx_pps + 0.5));
+            tx_bps.record(static_cast<uint64_t>(r.tx_bps + 0.5));
+            tx_pps.record(static_cast<uint64_t>(r.tx_pps + 0.5));
+            drops.record(static_cast<uint64_t>(r.drops + 0.5));
+        }
+
+        void
+        merge(const rate_histogram &other)
+        {
+            rx_bps.merge(other.rx_bps);
+            rx_pps.merge(other.rx_pps);
+            tx_bps.merge(other.tx_bps);
+            tx_pps.merge(other.tx_pps);
+            drops.merge(other.drops);
+        }
+    };
+
+
+    static volatile sig_atomic_t interrupted;
+
+    static void
+    on_interrupt(int)
+    {
+        interrupted = 1;
+    }
+
+
+    std::string
+    human(double value)
+    {
+        const char *unit[] = { "", "K", "M", "G", "T" };
+
+        int u = 0;
+        while (value >= 1000.0 && u < 4) {
+            value /= 1000.0;
+            u++;
+        }
+
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(u ? 2 : 0) << value << unit[u];
+        return out.str();
+    }
+
+
+    std::vector<ifname>
+    select_interfaces(const options &opts)
+    {
+        std::vector<ifname> ret;
+
+        std::unordered_set<ifname> list(opts.if_list.begin(), opts.if_list.end());
+
+        for(auto &name : proc::get_if_list())
+        {
+            ifr iif(name);
+
+            if (!list.empty()) {
+                if (!list.count(name))
+                    continue;
+            }
+            else if (!opts.all) {
+                auto flags = iif.try_flags();
+                if (!flags || (*flags & IFF_UP) == 0)
+                    continue;
+            }
+
+            if (!opts.driver.empty())
+            {
+                auto info = iif.try_ethtool_info();
+                if (!info)
+                    continue;
+                if (std::all_of(std::begin(opts.driver), std::end(opts.driver), [&](const std::string &drv) -> bool
+                                {
+                                    return strstr(info->driver, drv.c_str()) == nullptr;
+                                }))
+                    continue;
+            }
+
+            ret.push_back(name);
+        }
+
+        return ret;
+    }
+
+
+    // delta holds all the counters of the stats_sampler (as ifshowd does)
+    // for each interface
+    //
+    static std::vector<rate>
+    compute_rates(size_t interfaces, const std::vector<uint64_t> &delta, double secs)
+    {
+        typedef sysfs::stats_sampler s;
+
+        std::vector<rate> ret;
+        ret.reserve(interfaces);
+
+        for(size_t i = 0; i < interfaces; i++)
+        {
+            const uint64_t *d = &delta[i * s::max_counter];
+
+            ret.push_back(rate{ i,
+                                d[s::rx_bytes] * 8 / secs, d[s::rx_packets] / secs,
+                                d[s::tx_bytes] * 8 / secs, d[s::tx_packets] / secs,
+                                (d[s::rx_dropped] + d[s::tx_dropped]) / secs,
+                                (d[s::rx_errors] + d[s::tx_errors]) / secs });
+        }
+
+        return ret;
+    }
+
+
+    static void
+    print_rates(const std::vector<ifname> &names, const std::vector<rate> &rates, size_t width)
+    {
+        std::cout << bold() << std::left << std::setw(width) << "iface" << std::right
+                  << std::setw(10) << "rx bps" << std::setw(10) << "rx pps"
+                  << std::setw(10) << "tx bps" << std::setw(10) << "tx pps"
+                  << std::setw(10) << "drops/s" << std::setw(10) << "errors/s" << reset() << std::endl;
+
+        for(auto &r : rates)
+        {
+            std::cout << cyan() << std::left << std::setw(width) << names[r.index] << reset() << std::right
+                      << std::setw(10) << human(r.rx_bps) << std::setw(10) << human(r.rx_pps)
+                      << std::setw(10) << human(r.tx_bps) << std::setw(10) << human(r.tx_pps);
+
+            if (r.drops)
+                std::cout << red();
+            std::cout << std::setw(10) << human(r.drops) << reset();
+
+            if (r.errors)
+                std::cout << red();
+            std::cout << std::setw(10) << human(r.errors) << reset() << std::endl;
+        }
+    }
+
+
+    static void
+    print_driver_rates(const nic &n, const std::vector<uint64_t> &delta, const std::vector<uint64_t> &mask,
+                       double secs, size_t width)
+    {
+        auto &layout = *n.layout;
+
+        // only walk the counters that changed...
+        //
+        std::vector<size_t> changed;
+
+        size_t begin = n.offset, end = n.offset + layout.size();
+        for(size_t w = begin / 64; w < mask_words(end); w++)
+        {
+            for(uint64_t m = mask[w]; m; m &= m - 1)
+            {
+                size_t i = w * 64 + __builtin_ctzll(m);
+                if (i >= begin && i < end)
+                    changed.push_back(i - begin);
+            }
+        }
+
+        if (changed.empty())
+            return;
+
+        std::stable_sort(changed.begin(), changed.end(), [&](size_t a, size_t b) {
+                            return layout.queue[a] < layout.queue[b];
+                         });
+
+        std::cout << cyan() << std::left << std::setw(width) << n.iif.name() << reset();
+
+        int queue = -2;
+        for(auto i : changed)
+        {
+            if (layout.queue[i] != queue) {
+                if (queue != -2)
+                    std::cout << std::endl << more::spaces(width);
+                queue = layout.queue[i];
+                if (queue < 0)
+                    std::cout << "device";
+                else
+                    std::cout << "queue " << queue;
+            }
+
+            std::cout << ' ' << layout.label[i] << ':' << human(delta[n.offset + i] / secs);
+        }
+
+        std::cout << std::endl;
+    }
+
+
+    static void
+    print_histograms(const std::vector<ifname> &names, const std::vector<rate_histogram> &hists,
+                     const std::vector<size_t> &which, size_t width)
+    {
+        std::cout << bold() << std::left << std::setw(width) << "iface" << std::setw(10) << "rate" << std::right
+                  << std::setw(10) << "p50" << std::setw(10) << "p90" << std::setw(10) << "p99"
+                  << std::setw(10) << "max" << std::setw(10) << "ticks" << reset() << std::endl;
+
+        auto row = [&](const std::string &name, const rate_histogram &h)
+        {
+            const std::pair<const char *, const histogram *> metric[] =
+            {
+                { "rx bps", &h.rx_bps }, { "rx pps", &h.rx_pps }, { "tx bps", &h.tx_bps },
+                { "tx pps", &h.tx_pps }, { "drops/s", &h.drops }
+            };
+
+            std::cout << cyan() << std::left << std::setw(width) << name << reset();
+
+            // idle rates are not displayed
+            //
+            bool first = true;
+            for(auto &[label, hist] : metric)
+            {
+                if (hist->max() == 0)
+                    continue;
+
+                if (!first)
+                    std::cout << more::spaces(width);
+                first = false;
+
+                std::cout << std::left << std::setw(10) << label << std::right
+                          << std::setw(10) << human(hist->percentile(50)) << std::setw(10) << human(hist->percentile(90))
+                          << std::setw(10) << human(hist->percentile(99)) << std::setw(10) << human(hist->max())
+                          << std::setw(10) << hist->count() << std::endl;
+            }
+
+            if (first)
+                std::cout << "idle" << std::endl;
+        };
+
+        rate_histogram all;
+
+        for(auto i : which)
+        {
+            row(names[i], hists[i]);
+            all.merge(hists[i]);
+        }
+
+        if (which.size() > 1)
+            row("all", all);
+    }
+
+
+    /*
+     * keep the k interfaces with the highest value of the sort key, in
+     * descending order: nth_element + sort of the first k, O(n + k log k)
+     */
+
+    static void
+    select_top(std::vector<rate> &rates, const std::string &key, size_t k)
+    {
+        double rate::*field = &rate::rx_bps;
+
+        if (key == "rx_pps")
+            field = &rate::rx_pps;
+        else if (key == "tx_bps")
+            field = &rate::tx_bps;
+        else if (key == "tx_pps")
+            field = &rate::tx_pps;
+        else if (key == "drops")
+            field = &rate::drops;
+        else if (key == "errors")
+            field = &rate::errors;
+
+        auto cmp = [=](const rate &a, const rate &b) {
+            return a.*field != b.*field ? a.*field > b.*field : a.index < b.index;
+        };
+
+        k = std::min(k, rates.size());
+
+        std::nth_element(rates.begin(), rates.begin() + k, rates.end(), cmp);
+        rates.resize(k);
+        std::sort(rates.begin(), rates.end(), cmp);
+    }
+
+
+    int
+    watch_interfaces(const options &opts)
+    try
+    {
+        // the counters come either from the sysfs sampler or, with --shm,
+        // from the ifshowd ring (no kernel calls)
+        //
+        std::unique_ptr<sysfs::stats_sampler> sampler;
+        std::unique_ptr<shm::reader> ring;
+        std::vector<ifname> ifs;
+
+        if (opts.shm.empty()) {
+            ifs = select_interfaces(opts);
+            if (ifs.empty())
+                throw std::runtime_error("no interface to watch");
+            sampler.reset(new sysfs::stats_sampler(ifs));
+        }
+        else {
+            ring.reset(new shm::reader(opts.shm));
+            if (ring->counters() != sysfs::stats_sampler::max_counter)
+                throw std::runtime_error("shm ring: unexpected counters");
+            ifs = ring->names();
+        }
+
+        // the displayed interfaces (all of them, unless a list is given to --shm)
+        //
+        std::unordered_set<ifname> list(opts.if_list.begin(), opts.if_list.end());
+
+        auto displayed = [&](const rate &r) {
+            return !ring || list.empty() || list.count(ifs[r.index]);
+        };
+
+        size_t width = 0;
+        for(auto &name : ifs)
+            width = std::max(width, name.size() + 2);
+
+        size_t size = ifs.size() * sysfs::stats_sampler::max_counter;
+
+        std::vector<uint64_t> prev(size), cur(size), delta(size);
+        std::vector<uint64_t> mask(mask_words(size));
+
+        // sample all the counters, return the timestamp in seconds
+        //
+        auto sample = [&](uint64_t *out) -> double
+        {
+            if (ring) {
+                uint64_t ns;
+                if (!ring->latest(out, ns))
+                    throw std::runtime_error("shm ring: no snapshot published yet");
+                return ns / 1e9;
+            }
+
+            sampler->sample(out);
+            return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        };
+
+        std::vector<rate_histogram> hists(opts.histogram ? ifs.size() : 0);
+
+        std::vector<size_t> which;
+        for(size_t i = 0; i < ifs.size(); i++)
+            if (displayed(rate{ i, 0, 0, 0, 0, 0, 0 }))
+                which.push_back(i);
+
+        // one-shot, with histograms: the distribution of the rates over the
+        // snapshots still in the ring
+        //
+        if (ring && opts.watch <= 0.0 && opts.histogram)
+        {
+            uint64_t h = ring->head(), t0 = 0, t1;
+            uint64_t n = h > ring->slots() - 1 ? h - (ring->slots() - 1) : 0;
+
+            for(bool first = true; n < h; n++)
+            {
+                // the oldest snapshots may be recycled while reading
+                //
+                if (!ring->read(n, cur.data(), t1)) {
+                    first = true;
+                    continue;
+                }
+
+                if (!first) {
+                    counter_delta(prev.data(), cur.data(), delta.data(), mask.data(), size);
+                    for(auto &r : compute_rates(ifs.size(), delta, (t1 - t0) / 1e9))
+                        hists[r.index].record(r);
+                }
+
+                first = false;
+                prev.swap(cur);
+                t0 = t1;
+            }
+
+            print_histograms(ifs, hists, which, width);
+            return 0;
+        }
+
+        // one-shot: the rates between the last two snapshots of the ring
+        //
+        if (ring && opts.watch <= 0.0)
+        {
+            uint64_t h = ring->head(), t0, t1;
+            if (h < 2 || !ring->read(h - 2, prev.data(), t0) || !ring->read(h - 1, cur.data(), t1))
+                throw std::runtime_error("shm ring: not enough snapshots");
+
+            counter_delta(prev.data(), cur.data(), delta.data(), mask.data(), size);
+
+            auto rates = compute_rates(ifs.size(), delta, (t1 - t0) / 1e9);
+            rates.erase(std::remove_if(rates.begin(), rates.end(), [&](const rate &r) { return !displayed(r); }), rates.end());
+
+            if (!opts.sort.empty() || opts.top)
+                select_top(rates, opts.sort, opts.top ? opts.top : rates.size());
+
+            print_rates(ifs, rates, width);
+            return 0;
+        }
+
+        // the driver statistics of the NICs are kept in contiguous arrays,
+        // so that a single counter_delta() covers them all. NICs are probed
+        // lazily, the first time they are selected for display.
+        //
+        std::vector<nic> nics;
+        for(auto &name : ifs)
+            nics.push_back(nic{ ifr(name), nullptr, 0, 0, false, std::numeric_limits<unsigned long>::max() });
+
+        std::vector<uint64_t> eprev, ecur, edelta, emask;
+
+        auto probe = [&](nic &n)
+        {
+            n.probed = true;
+
+            auto info = n.iif.try_ethtool_info();
+            if (!info || info->n_stats == 0)
+                return;
+
+            // the NIC may vanish while probed: no driver statistics for it
+            //
+            try
+            {
+                n.layout = ethtool::get_stats_layout(n.iif, *info);
+            }
+            catch(std::system_error &)
+            {
+                return;
+            }
+
+            // re-probed (the statistics changed): the region of the NIC is
+            // reused if large enough, or grown if it's the last one
+            //
+            if (n.layout->size() <= n.room)
+                return;
+
+            if (!n.room || n.offset + n.room != eprev.size())
+                n.offset = eprev.size();
+
+            n.room = n.layout->size();
+
+            size_t size = n.offset + n.room;
+            eprev.resize(size);
+            ecur.resize(size);
+            edelta.resize(size);
+            emask.resize(mask_words(size));
+        };
+
+        // read the driver statistics of the selected NICs only; the others
+        // keep their previous values (and a zero delta)
+        //
+        std::vector<bool> selected(nics.size()), shown(nics.size());
+
+        auto sample_driver = [&](unsigned long tick)
+        {
+            for(size_t i = 0; i < nics.size(); i++)
+            {
+                auto &n = nics[i];
+
+                if (selected[i] && !n.probed)
+                    probe(n);
+
+                if (!n.layout)
+                    continue;
+
+                if (selected[i]) {
+                    auto ok = n.iif.try_ethtool_stats(ecur.data() + n.offset, static_cast<uint32_t>(n.layout->size()));
+                    if (ok) {
+                        shown[i] = tick > 0 && n.sampled == tick - 1;
+                        n.sampled = tick;
+                        continue;
+                    }
+
+                    // the statistics changed (e.g. channels reconfigured):
+                    // probe the NIC again at the next tick. On other errors
+                    // (the NIC vanished) it's just not shown this time.
+                    //
+                    if (ok.error() == EAGAIN) {
+                        n.probed = false;
+                        n.layout.reset();
+                    }
+
+                    shown[i] = false;
+                    n.sampled = std::numeric_limits<unsigned long>::max();
+                }
+                else {
+                    std::copy(eprev.begin() + n.offset, eprev.begin() + n.offset + n.layout->size(), ecur.begin() + n.offset);
+                    shown[i] = false;
+                }
+            }
+        };
+
+        bool top = opts.top || !opts.sort.empty();
+
+        auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(opts.watch));
+
+        // the driver statistics need ioctls: not in --shm mode
+        //
+        bool verbose = opts.verbose && !ring;
+
+        double last = sample(prev.data());
+
+        if (verbose && !opts.top)
+        {
+            std::fill(selected.begin(), selected.end(), true);
+            sample_driver(0);
+            eprev.swap(ecur);
+        }
+
+        auto next = std::chrono::steady_clock::now() + interval;
+
+        unsigned long printed = 0;
+
+        // with histograms, ^C ends the watch and displays them
+        //
+        if (opts.histogram)
+            signal(SIGINT, on_interrupt);
+
+        for(unsigned long tick = 1; (opts.count == 0 || tick <= opts.count) && !interrupted; tick++)
+        {
+            std::this_thread::sleep_until(next);
+            next += interval;
+
+            double now = sample(cur.data());
+
+            // no new snapshot in the ring yet
+            //
+            if (now <= last)
+                continue;
+
+            double secs = now - last;
+            last = now;
+
+            counter_delta(prev.data(), cur.data(), delta.data(), mask.data(), cur.size());
+
+            auto rates = compute_rates(ifs.size(), delta, secs);
+
+            // the interfaces deleted while watching are not displayed
+            //
+            if (sampler)
+                rates.erase(std::remove_if(rates.begin(), rates.end(), [&](const rate &r) { return sampler->failed(r.index); }), rates.end());
+
+            if (!hists.empty())
+                for(auto &r : rates)
+                    hists[r.index].record(r);
+
+            if (ring)
+                rates.erase(std::remove_if(rates.begin(), rates.end(), [&](const rate &r) { return !displayed(r); }), rates.end());
+            if (top)
+                select_top(rates, opts.sort, opts.top ? opts.top : rates.size());
+
+            if (printed++)
+                std::cout << std::endl;
+
+            print_rates(ifs, rates, width);
+
+            // expensive details for the displayed interfaces only
+            //
+            if (verbose)
+            {
+                std::fill(selected.begin(), selected.end(), false);
+                for(auto &r : rates)
+                    selected[r.index] = true;
+
+                sample_driver(tick);
+                counter_delta(eprev.data(), ecur.data(), edelta.data(), emask.data(), ecur.size());
+
+                for(auto &r : rates)
+                {
+                    if (shown[r.index])
+                        print_driver_rates(nics[r.index], edelta, emask, secs, width);
+                }
+
+                eprev.swap(ecur);
+            }
+
+            std::cout << std::flush;
+
+            prev.swap(cur);
+        }
+
+        if (opts.histogram)
+        {
+            if (printed)
+                std::cout << std::endl;
+            print_histograms(ifs, hists, which, width);
+        }
+
+        return 0;
+    }
+    catch(std::exception &e)
+    {
+        std::cerr << "ifshow: " << e.what() << std::endl;
+        return 1;
+    }
+
+} // namespace watch
+} // namespace ifshow
+
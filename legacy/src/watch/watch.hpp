@@ -0,0 +1,69 @@
+/*
+ *  Copyright (c) 2004-2010 Bonelli Nicola <bonelli@antifork.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <options.hpp>
+#include <proc/interrupt.hpp>
+
+namespace ifshow { namespace watch {
+
+    // sample the selected interfaces every opts.watch seconds and display
+    // the rates (and, in verbose mode, the changing driver statistics)
+    //
+    extern int watch_interfaces(const options &opts);
+
+    // sample the selected interfaces every opts.burst milliseconds from a
+    // pinned thread and display, per window, the peak rates and the bursts
+    //
+    extern int burst_interfaces(const options &opts);
+
+    // display the bond/bridge/vlan hierarchy with the rates of the
+    // interfaces, the slaves aggregated up to their master
+    //
+    extern int tree_interfaces(const options &opts);
+
+    // display the IRQs of the NICs with their affinity and the interrupt
+    // rates per CPU
+    //
+    extern int irq_interfaces(const options &opts);
+
+    // compare the NUMA node of the NICs with the CPUs serving their IRQs
+    // and their RPS/XPS queues
+    //
+    extern int numa_interfaces(const options &opts);
+
+    // display the RPS/RFS/XPS configuration of the queues of the NICs
+    //
+    extern int queue_interfaces(const options &opts);
+
+    // the interfaces selected by the options (list, UP or -a, driver)
+    //
+    extern std::vector<ifname> select_interfaces(const options &opts);
+
+    // 1234567 -> 1.23M
+    //
+    extern std::string human(double value);
+
+} // namespace watch
+} // namespace ifshow
+